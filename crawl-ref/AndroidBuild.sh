@@ -64,7 +64,7 @@ done
 )
 
 # libraries that have a missing "include" directory (including some CrystaX integration)
-MISSING_INCLUDE="-isystem$LOCAL_PATH/../sqlite  -isystem$NDK/sources/crystax/include"
+MISSING_INCLUDE="-isystem$NDK/sources/crystax/include"
 MISSING_LIB=
 
 # tell tools what the final shared library will be called
@@ -227,11 +227,6 @@ static inline double pow(int x, double y) { return std::pow((double)x, y); }
     // share the same savedir.
     #define DGL_VERSIONED_CACHE_DIR
 
-    // Update (text) database files safely; when a Crawl process
-    // starts up and notices that a db file is out-of-date, it updates
-    // it in-place, instead of torching the old file.
-    #define DGL_REWRITE_PROTECT_DB_FILES
-
     // Startup preferences are saved by player name rather than uid,
     // since all players use the same uid in dgamelaunch.
     #ifndef DGL_NO_STARTUP_PREFS_BY_NAME
@@ -323,6 +318,10 @@ static inline double pow(int x, double y) { return std::pow((double)x, y); }
     #define DEBUG_ITEM_SCAN
     #define DEBUG_MONS_SCAN
 
+    // Recompute cached player and monster resistances on every lookup
+    // and check that they haven't gone stale.
+    #define DEBUG_STAT_CACHE
+
     #define DEBUG_BONES
 #endif
 
@@ -365,6 +364,8 @@ static inline double pow(int x, double y) { return std::pow((double)x, y); }
 
 // number of older messages stored during play and in save files
 #define NUM_STORED_MESSAGES   1000
+// bytes of message text (and headers) kept for them
+#define MESSAGE_HISTORY_BYTES (NUM_STORED_MESSAGES * 128)
 
 // clamp time between command inputs at 30 seconds when reporting play time.
 // Anything longer means you do something other than playing -- heck, even 30s
@@ -390,10 +391,6 @@ static inline double pow(int x, double y) { return std::pow((double)x, y); }
 // these -- usually this means you should place them in ~/.crawl/
 // unless it's a DGL build.
 
-#if !defined(DB_NDBM) && !defined(DB_DBH) && !defined(USE_SQLITE_DBM)
-#define USE_SQLITE_DBM
-#endif
-
 // Uncomment these if you can't find these functions on your system
 // #define NEED_USLEEP
 
@@ -62,7 +62,8 @@ static const int ABYSSAL_RUNE_MIN_LEVEL = 3;
 
 abyss_state abyssal_state;
 
-static ProceduralLayout *abyssLayout = nullptr, *levelLayout = nullptr;
+static ProceduralLayout *abyssLayout = nullptr, *levelLayout = nullptr,
+                        *complexLayout = nullptr;
 
 typedef priority_queue<ProceduralSample, vector<ProceduralSample>, ProceduralSamplePQCompare> sample_queue;
 
@@ -739,6 +740,11 @@ static void _abyss_move_entities(coord_def target_centre,
 
     end += direction;
 
+    // Squares that something has been moved off.  Everything outside the
+    // shifted area has already been wiped, so these are the only ones that
+    // can still hold anything.
+    map_bitmask vacated;
+
     for (int y = start.y; y != end.y; y += direction.y)
     {
         for (int x = start.x; x != end.x; x += direction.x)
@@ -753,9 +759,11 @@ static void _abyss_move_entities(coord_def target_centre,
             if (map_bounds_with_margin(dst, MAPGEN_BORDER))
             {
                 shift_area_mask->set(dst);
-                // Wipe the dstination clean before dropping things on it.
-                _abyss_wipe_square_at(dst);
+                // Wipe the destination clean before dropping things on it.
+                if (vacated(dst))
+                    _abyss_wipe_square_at(dst);
                 _abyss_move_entities_at(src, dst);
+                vacated.set(src);
             }
             else
             {
@@ -765,6 +773,15 @@ static void _abyss_move_entities(coord_def target_centre,
         }
     }
 
+    // [ds] Wipe whatever was left behind at the old location.  NOTE: the
+    // old code did not do this, leaving a repeated swatch of Abyss behind
+    // at the old location for every shift; discussions between Linley
+    // and dpeg on ##crawl confirm that this (repeated swatch of
+    // terrain left behind) was not intentional.
+    for (rectangle_iterator ri(MAPGEN_BORDER); ri; ++ri)
+        if (vacated(*ri) && !shift_area_mask->get(*ri))
+            _abyss_wipe_square_at(*ri);
+
     _abyss_move_masked_vaults_by_delta(target_centre - source_centre);
 }
 
@@ -860,16 +877,10 @@ static void _abyss_shift_level_contents_around_player(
     // nothing in the way of moving stuff.
     _abyss_wipe_unmasked_area(abyss_destruction_mask);
 
-    // Move stuff to its new home. This will also move the player.
+    // Move stuff to its new home. This will also move the player, and
+    // clean up the squares the shifted area leaves behind.
     _abyss_move_entities(target_centre, &abyss_destruction_mask);
 
-    // [ds] Rezap everything except the shifted area. NOTE: the old
-    // code did not do this, leaving a repeated swatch of Abyss behind
-    // at the old location for every shift; discussions between Linley
-    // and dpeg on ##crawl confirm that this (repeated swatch of
-    // terrain left behind) was not intentional.
-    _abyss_wipe_unmasked_area(abyss_destruction_mask);
-
     // So far we've used the mask to track the portions of the level we're
     // preserving. The inverse of the mask represents the area to be filled
     // with brand new abyss:
@@ -1045,7 +1056,10 @@ static ProceduralSample _abyss_grid(const coord_def &p)
         levelLayout = new LevelLayout(lid, 5, rivers);
         complex_vec[0] = levelLayout;
         complex_vec[1] = &rivers; // const
-        abyssLayout = new WorleyLayout(23571113, complex_vec, 6.1);
+        complexLayout = new WorleyLayout(23571113, complex_vec, 6.1);
+        // Shifting the abyss regenerates most of the area around the player,
+        // usually at the same depth as before.
+        abyssLayout = new CacheLayout(*complexLayout);
     }
 
     const ProceduralSample sample = (*abyssLayout)(pt, abyssal_state.depth);
@@ -1468,6 +1482,8 @@ void destroy_abyss()
     {
         delete abyssLayout;
         abyssLayout = nullptr;
+        delete complexLayout;
+        complexLayout = nullptr;
         delete levelLayout;
         levelLayout = nullptr;
     }
@@ -546,6 +546,18 @@ bool silenced(const coord_def& p)
     return _check_agrid_flag(p, APROP_SILENCE);
 }
 
+// Whether silenced() can be true anywhere on the level, for callers that
+// would otherwise ask it about many cells.
+bool any_silence()
+{
+    if (!_agrid_valid)
+        _update_agrid();
+    for (unsigned int i = 0; i < _agrid_centres.size(); ++i)
+        if (_agrid_centres[i].type == AREA_SILENCE)
+            return true;
+    return false;
+}
+
 /////////////
 // Halos
 
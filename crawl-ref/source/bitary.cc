@@ -77,3 +77,20 @@ bit_vector bit_vector::operator & (const bit_vector& other) const
         res.data[w] = data[w] & other.data[w];
     return res;
 }
+
+// Index of the lowest set bit of a non-zero word, by de Bruijn
+// multiplication: isolating that bit and multiplying by the sequence leaves
+// a distinct pattern in the top six bits for each position.
+int lowest_set_bit(uint64_t x)
+{
+    static const int pos[64] =
+    {
+         0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6,
+    };
+
+    ASSERT(x);
+    return pos[((x & (~x + 1)) * 0x03f79d71b4cb0a89ULL) >> 58];
+}
@@ -179,4 +179,77 @@ public:
     }
 };
 
+int lowest_set_bit(uint64_t x);
+
+// A set of slots in a fixed-size table that can hand out its lowest member
+// in constant time: one bit per slot, plus a summary word of which 64-slot
+// words are non-empty.
+template <unsigned int SIZE> class FreeSlotMap
+{
+protected:
+    enum { NWORDS = (SIZE + 63) / 64 };
+    uint64_t words[NWORDS];
+    uint64_t nonempty;
+public:
+    FreeSlotMap()
+    {
+        COMPILE_CHECK(NWORDS <= 64);
+        init(true);
+    }
+
+    void init(bool value)
+    {
+        nonempty = 0;
+        for (unsigned int w = 0; w < NWORDS; ++w)
+        {
+            words[w] = 0;
+            if (value)
+            {
+                words[w] = ~(uint64_t)0;
+                if (w == NWORDS - 1 && SIZE % 64)
+                    words[w] >>= 64 - SIZE % 64;
+                nonempty |= (uint64_t)1 << w;
+            }
+        }
+    }
+
+    inline bool get(unsigned int i) const
+    {
+#ifdef ASSERTS
+        if (i >= SIZE)
+            die("slot map range error: %d / %u", (int)i, SIZE);
+#endif
+        return words[i / 64] & ((uint64_t)1 << (i % 64));
+    }
+
+    inline void set(unsigned int i, bool value = true)
+    {
+#ifdef ASSERTS
+        if (i >= SIZE)
+            die("slot map range error: %d / %u", (int)i, SIZE);
+#endif
+        const unsigned int w = i / 64;
+        if (value)
+        {
+            words[w] |= (uint64_t)1 << (i % 64);
+            nonempty |= (uint64_t)1 << w;
+        }
+        else
+        {
+            words[w] &= ~((uint64_t)1 << (i % 64));
+            if (!words[w])
+                nonempty &= ~((uint64_t)1 << w);
+        }
+    }
+
+    // The lowest slot in the set, or -1 if it is empty.
+    int first() const
+    {
+        if (!nonempty)
+            return -1;
+        const int w = lowest_set_bit(nonempty);
+        return w * 64 + lowest_set_bit(words[w]);
+    }
+};
+
 #endif
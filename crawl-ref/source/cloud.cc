@@ -205,6 +205,10 @@ static void _new_cloud(int cloud, cloud_type type, const coord_def& p,
     }
     c.tile        = tile;
     env.cgrid(p)  = cloud;
+
+    env.active_clouds[env.cloud_no] = cloud;
+    env.cloud_slot[cloud] = env.cloud_no;
+    env.free_clouds.set(cloud, false);
     env.cloud_no++;
 
     _los_cloud_changed(p, type);
@@ -221,16 +225,8 @@ static void _place_new_cloud(cloud_type cltype, const coord_def& p, int decay,
         return;
     ASSERT(!cell_is_solid(p));
 
-    // Find slot for cloud.
-    for (int ci = 0; ci < MAX_CLOUDS; ci++)
-    {
-        if (env.cloud[ci].type == CLOUD_NONE)   // i.e., is empty
-        {
-            _new_cloud(ci, cltype, p, decay, whose, killer, source, spread_rate,
-                       colour, name, tile, excl_rad);
-            break;
-        }
-    }
+    _new_cloud(env.free_clouds.first(), cltype, p, decay, whose, killer,
+               source, spread_rate, colour, name, tile, excl_rad);
 }
 
 static int _spread_cloud(const cloud_struct &cloud)
@@ -394,8 +390,20 @@ static void _handle_ghostly_flame(const cloud_struct& cloud)
 
 void manage_clouds()
 {
-    for (int i = 0; i < MAX_CLOUDS; ++i)
+    // Spreading and dissipating clouds reorder the active list, so work
+    // from a copy of it.
+    short clouds[MAX_CLOUDS];
+    const int nclouds = env.cloud_no;
+    for (int k = 0; k < nclouds; ++k)
+        clouds[k] = env.active_clouds[k];
+
+    // Clouds only hurt the items under them once the whole pass is done,
+    // and only where there are items at all.
+    vector<pair<coord_def, beam_type> > exposed;
+
+    for (int k = 0; k < nclouds; ++k)
     {
+        const int i = clouds[k];
         cloud_struct& cloud = env.cloud[i];
 
         if (cloud.type == CLOUD_NONE)
@@ -425,10 +433,14 @@ void manage_clouds()
             _handle_ghostly_flame(cloud);
 
         _cloud_interacts_with_terrain(cloud);
-        expose_items_to_element(_cloud2beam(cloud.type), cloud.pos, 2);
+        if (igrd(cloud.pos) != NON_ITEM)
+            exposed.push_back(make_pair(cloud.pos, _cloud2beam(cloud.type)));
 
         _dissipate_cloud(i, dissipate);
     }
+
+    for (unsigned int k = 0; k < exposed.size(); ++k)
+        expose_items_to_element(exposed[k].second, exposed[k].first, 2);
 }
 
 static void _maybe_leave_water(const cloud_struct& c)
@@ -492,7 +504,36 @@ void delete_cloud(int cloud)
         env.cgrid(c.pos) = EMPTY_CLOUD;
         _los_cloud_changed(c.pos, t);
         c.pos.reset();
-        env.cloud_no--;
+
+        // Move the last active cloud into the vacated place in the list.
+        const int slot = env.cloud_slot[cloud];
+        const int last = env.active_clouds[--env.cloud_no];
+        env.active_clouds[slot] = last;
+        env.cloud_slot[last] = slot;
+        env.free_clouds.set(cloud);
+    }
+}
+
+void delete_all_clouds()
+{
+    while (env.cloud_no > 0)
+        delete_cloud(env.active_clouds[env.cloud_no - 1]);
+}
+
+// Rebuilds the active and free cloud lists from env.cloud, after it has
+// been filled in directly.
+void rebuild_cloud_lists()
+{
+    env.cloud_no = 0;
+    for (int i = 0; i < MAX_CLOUDS; i++)
+    {
+        const bool defined = env.cloud[i].type != CLOUD_NONE;
+        env.free_clouds.set(i, !defined);
+        if (defined)
+        {
+            env.cloud_slot[i] = env.cloud_no;
+            env.active_clouds[env.cloud_no++] = i;
+        }
     }
 }
 
@@ -531,6 +572,13 @@ static void _validate_clouds()
     for (int c = 0; c < MAX_CLOUDS; c++)
         if (env.cloud[c].type != CLOUD_NONE)
             ASSERT(env.cgrid(env.cloud[c].pos) == c);
+
+    for (int k = 0; k < env.cloud_no; k++)
+    {
+        const int c = env.active_clouds[k];
+        ASSERT(env.cloud[c].type != CLOUD_NONE);
+        ASSERT(env.cloud_slot[c] == k);
+    }
 }
 #endif
 
@@ -685,16 +733,9 @@ void place_cloud(cloud_type cl_type, const coord_def& ctarget, int cl_range,
     }
     else
     {
-        // Find slot for cloud.
-        for (int ci = 0; ci < MAX_CLOUDS; ci++)
-        {
-            if (env.cloud[ci].type == CLOUD_NONE)   // ie is empty
-            {
-                _new_cloud(ci, cl_type, ctarget, cl_range * 10, whose, killer,
-                           source, spread_rate, colour, name, tile, excl_rad);
-                break;
-            }
-        }
+        _new_cloud(env.free_clouds.first(), cl_type, ctarget, cl_range * 10,
+                   whose, killer, source, spread_rate, colour, name, tile,
+                   excl_rad);
     }
 }
 
@@ -1545,9 +1586,13 @@ void remove_tornado_clouds(mid_t whose)
     // example, this approach doesn't work if we ever make Tornado a monster
     // spell (excluding immobile and mindless casters).
 
-    for (int i = 0; i < MAX_CLOUDS; i++)
+    // Backwards, since deleting a cloud moves the last one into its place.
+    for (int k = env.cloud_no - 1; k >= 0; k--)
+    {
+        const int i = env.active_clouds[k];
         if (env.cloud[i].type == CLOUD_TORNADO && env.cloud[i].source == whose)
             delete_cloud(i);
+    }
 }
 
 static void _spread_cloud(coord_def pos, cloud_type type, int radius, int pow,
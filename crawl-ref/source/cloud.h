@@ -15,6 +15,8 @@ cloud_type cloud_type_at(const coord_def &pos);
 
 void delete_cloud(int cloud);
 void delete_cloud_at(coord_def p);
+void delete_all_clouds();
+void rebuild_cloud_lists();
 void move_cloud(int cloud, const coord_def& newpos);
 void move_cloud_to(coord_def src, coord_def dest);
 void swap_clouds(coord_def p1, coord_def p2);
@@ -8,6 +8,9 @@
 
 #include "files.h"
 #include "libutil.h"
+#include "message.h"
+#include "options.h"
+#include "player.h"
 #include "state.h"
 #include "stuff.h"
 #include "syscalls.h"
@@ -43,7 +46,8 @@ CLua::CLua(bool managed)
       throttle_sleep_ms(0), throttle_sleep_start(2),
       throttle_sleep_end(800), n_throttle_sleeps(0), mixed_call_depth(0),
       lua_call_depth(0), max_mixed_call_depth(8),
-      max_lua_call_depth(100), memory_used(0),
+      max_lua_call_depth(100), pool(), memory_used(0), memory_peak(0),
+      n_allocs(0), turn_allocs(0), prev_turn_allocs(0), alloc_turn(0),
       _state(NULL), sourced_files(), uniqindex(0)
 {
 }
@@ -308,7 +312,7 @@ bool CLua::runhook(const char *hook, const char *params, ...)
         // So what's on top *is* a function. Call it with the args we have.
         va_list args;
         va_start(args, params);
-        calltopfn(ls, params, args);
+        calltopfn(ls, hook, params, args);
         va_end(args);
 
         lua_settop(ls, currtop);
@@ -474,15 +478,14 @@ int CLua::return_count(lua_State *ls, const char *format)
     return 0;
 }
 
-bool CLua::calltopfn(lua_State *ls, const char *params, va_list args,
-                     int retc, va_list *copyto)
+bool CLua::calltopfn(lua_State *ls, const char *fn, const char *params,
+                     va_list args, int retc, va_list *copyto)
 {
     // We guarantee to remove the function from the stack
     int argc = push_args(ls, params, args, copyto);
     if (retc == -1)
         retc = return_count(ls, params);
-    lua_call_throttle strangler(this);
-    int err = lua_pcall(ls, argc, retc, 0);
+    int err = profiled_pcall(ls, fn, argc, retc);
     set_error(err, ls);
     return !err;
 }
@@ -504,7 +507,7 @@ maybe_bool CLua::callmbooleanfn(const char *fn, const char *params,
         CL_RESETSTACK_RETURN(ls, stacktop, MB_MAYBE);
     }
 
-    bool ret = calltopfn(ls, params, args, 1);
+    bool ret = calltopfn(ls, fn, params, args, 1);
     if (!ret)
         CL_RESETSTACK_RETURN(ls, stacktop, MB_MAYBE);
 
@@ -589,7 +592,7 @@ bool CLua::callfn(const char *fn, const char *params, ...)
     va_list args;
     va_list fnret;
     va_start(args, params);
-    bool ret = calltopfn(ls, params, args, -1, &fnret);
+    bool ret = calltopfn(ls, fn, params, args, -1, &fnret);
     if (ret)
     {
         // If we have a > in format, gather return params now.
@@ -623,18 +626,124 @@ bool CLua::callfn(const char *fn, int nargs, int nret)
             lua_insert(ls, -nargs - 1);
     }
 
-    lua_call_throttle strangler(this);
-    int err = lua_pcall(ls, nargs, nret, 0);
+    int err = profiled_pcall(ls, fn, nargs, nret);
     set_error(err, ls);
     return !err;
 }
 
+// Calls the function sitting below its nargs arguments, under the
+// throttle.  Calls into a managed VM are timed under the hook name they
+// were made with if lua_profile or lua_hook_budget is set, and under the
+// Lua function that ran as well if lua_profile is.
+int CLua::profiled_pcall(lua_State *ls, const char *fn, int nargs, int nret)
+{
+    lua_call_throttle strangler(this);
+    if (!managed_vm || !Options.lua_profile && Options.lua_hook_budget <= 0)
+        return lua_pcall(ls, nargs, nret, 0);
+
+    string where;
+    if (Options.lua_profile)
+    {
+        lua_Debug ar;
+        lua_pushvalue(ls, -nargs - 1);
+        lua_getinfo(ls, ">S", &ar);
+        where = make_stringf("%s:%d", ar.short_src, ar.linedefined);
+    }
+
+    const uint64_t start = get_time_usec();
+    const int err = lua_pcall(ls, nargs, nret, 0);
+    note_call_time(fn ? fn : "(anonymous)", where, get_time_usec() - start);
+    return err;
+}
+
+static void _note_profile_call(lua_profile_entry &entry, double usec)
+{
+    ++entry.calls;
+    entry.total_usec += usec;
+    entry.max_usec = max(entry.max_usec, usec);
+    if (entry.turn != you.num_turns)
+    {
+        entry.turn = you.num_turns;
+        entry.turn_usec = 0;
+    }
+    entry.turn_usec += usec;
+}
+
+void CLua::note_call_time(const char *hook, const string &fn, double usec)
+{
+    if (!fn.empty())
+        _note_profile_call(fn_profile[fn], usec);
+
+    lua_profile_entry &entry = hook_profile[hook];
+    _note_profile_call(entry, usec);
+
+    // Warn only once per hook and turn, or a slow hook that runs many
+    // times a turn (such as autopickup checks) would flood the messages.
+    if (Options.lua_hook_budget > 0 && entry.warned_turn != entry.turn
+        && entry.turn_usec > Options.lua_hook_budget * 1000.0)
+    {
+        entry.warned_turn = entry.turn;
+        mprf(MSGCH_WARN, "Lua hook %s has taken %.1f ms this turn "
+                         "(lua_hook_budget = %d).",
+             hook, entry.turn_usec / 1000.0, Options.lua_hook_budget);
+    }
+}
+
+static bool _profile_slower(const pair<string, lua_profile_entry> &a,
+                            const pair<string, lua_profile_entry> &b)
+{
+    return a.second.total_usec > b.second.total_usec;
+}
+
+static string _profile_table(const string &title,
+                             const CLua::lua_profile &profile)
+{
+    vector<pair<string, lua_profile_entry> > entries(profile.begin(),
+                                                     profile.end());
+    sort(entries.begin(), entries.end(), _profile_slower);
+
+    string table = make_stringf("%-36s %8s %10s %8s %8s\n", title.c_str(),
+                                "calls", "total ms", "mean ms", "max ms");
+    for (unsigned int i = 0; i < entries.size(); ++i)
+    {
+        const lua_profile_entry &e = entries[i].second;
+        table += make_stringf("%-36s %8d %10.2f %8.3f %8.3f\n",
+                              entries[i].first.c_str(), e.calls,
+                              e.total_usec / 1000.0,
+                              e.total_usec / 1000.0 / e.calls,
+                              e.max_usec / 1000.0);
+    }
+    return table;
+}
+
+// Time spent in user scripts since the start of the game (or the last
+// reset_profile()), slowest first.
+string CLua::profile_report() const
+{
+    if (hook_profile.empty())
+    {
+        return Options.lua_profile ? "No Lua hooks have run.\n"
+                                   : "Lua hooks are only timed with "
+                                     "lua_profile = true.\n";
+    }
+    if (fn_profile.empty())
+        return _profile_table("Hook", hook_profile);
+    return _profile_table("Hook", hook_profile) + "\n"
+           + _profile_table("Function", fn_profile);
+}
+
+void CLua::reset_profile()
+{
+    hook_profile.clear();
+    fn_profile.clear();
+}
+
 void CLua::init_lua()
 {
     if (_state)
         return;
 
-    _state = managed_vm? lua_newstate(_clua_allocator, this) : luaL_newstate();
+    _state = lua_newstate(_clua_allocator, this);
     if (!_state)
         end(1, false, "Unable to create Lua state.");
 
@@ -679,6 +788,13 @@ void CLua::init_lua()
     {
         lua_register(_state, "pcall", _clua_guarded_pcall);
         execfile("dlua/userbase.lua", true, true);
+
+        // Keep userbase.lua's own autopickup hooks, so that autopickup can
+        // tell when a script has replaced them.
+        getglobal("ch_force_autopickup");
+        setregistry("ch_force_autopickup");
+        getglobal("ch_deny_autopickup");
+        setregistry("ch_deny_autopickup");
     }
 
     lua_pushboolean(_state, managed_vm);
@@ -954,21 +1070,143 @@ static int _clua_panic(lua_State *ls)
 static void *_clua_allocator(void *ud, void *ptr, size_t osize, size_t nsize)
 {
     CLua *cl = static_cast<CLua *>(ud);
-    cl->memory_used += nsize - osize;
+    const long delta = (long)nsize - (long)osize;
 
-    if (nsize > osize && cl->memory_used >= CLUA_MAX_MEMORY_USE * 1024
-        && cl->mixed_call_depth)
+    if (delta > 0 && cl->managed_vm && cl->mixed_call_depth
+        && cl->memory_used + delta >= CLUA_MAX_MEMORY_USE * 1024)
     {
         return NULL;
     }
 
-    if (!nsize)
+    void *block = cl->pool.reallocate(ptr, osize, nsize);
+    if (!block && nsize)
+        return NULL;
+
+    cl->memory_used += delta;
+    if (cl->memory_used > cl->memory_peak)
+        cl->memory_peak = cl->memory_used;
+    if (!ptr)
+        cl->note_allocation();
+
+    return block;
+}
+
+void CLua::note_allocation()
+{
+    ++n_allocs;
+    if (alloc_turn != you.num_turns)
+    {
+        prev_turn_allocs = alloc_turn + 1 == you.num_turns ? turn_allocs : 0;
+        turn_allocs = 0;
+        alloc_turn = you.num_turns;
+    }
+    ++turn_allocs;
+}
+
+// Allocations made during the last complete turn.
+int CLua::last_turn_allocs()
+{
+    if (alloc_turn == you.num_turns)
+        return prev_turn_allocs;
+    return alloc_turn + 1 == you.num_turns ? turn_allocs : 0;
+}
+
+/////////////////////////////////////////////////////////////////////
+// lua_pool
+
+lua_pool::lua_pool()
+    : slab_next(NULL), slab_end(NULL), slabs()
+{
+    memset(free_list, 0, sizeof free_list);
+}
+
+lua_pool::~lua_pool()
+{
+    for (int i = 0, size = slabs.size(); i < size; ++i)
+        free(slabs[i]);
+}
+
+void *lua_pool::allocate(size_t size)
+{
+    if (size > MAX_SIZE)
+        return malloc(size);
+
+    void *&head = free_list[size_class(size)];
+    if (head)
+    {
+        void *block = head;
+        head = *static_cast<void **>(block);
+        return block;
+    }
+
+    const size_t rounded = (size_class(size) + 1) * GRAIN;
+    if ((size_t)(slab_end - slab_next) < rounded)
+    {
+        char *slab = static_cast<char *>(malloc(SLAB_SIZE));
+        if (!slab)
+            return NULL;
+
+        // The rest of the old slab is too small for this block, but not
+        // necessarily for others.
+        if (slab_end != slab_next)
+            release(slab_next, slab_end - slab_next);
+
+        slabs.push_back(slab);
+        slab_next = slab;
+        slab_end = slab + SLAB_SIZE;
+    }
+
+    void *block = slab_next;
+    slab_next += rounded;
+    return block;
+}
+
+void lua_pool::release(void *ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    if (size > MAX_SIZE)
     {
         free(ptr);
+        return;
+    }
+
+    void *&head = free_list[size_class(size)];
+    *static_cast<void **>(ptr) = head;
+    head = ptr;
+}
+
+void *lua_pool::reallocate(void *ptr, size_t osize, size_t nsize)
+{
+    if (!nsize)
+    {
+        release(ptr, osize);
         return NULL;
     }
-    else
+
+    if (!ptr)
+        return allocate(nsize);
+
+    if (osize > MAX_SIZE && nsize > MAX_SIZE)
         return realloc(ptr, nsize);
+
+    if (osize <= MAX_SIZE && nsize <= MAX_SIZE
+        && size_class(osize) == size_class(nsize))
+    {
+        return ptr;
+    }
+
+    void *block = allocate(nsize);
+    if (!block)
+    {
+        // Lua assumes shrinking never fails.  The old block is big enough
+        // for any size class it can be released to later.
+        return nsize <= osize ? ptr : NULL;
+    }
+    memcpy(block, ptr, min(osize, nsize));
+    release(ptr, osize);
+    return block;
 }
 
 static void _clua_throttle_hook(lua_State *ls, lua_Debug *dbg)
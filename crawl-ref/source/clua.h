@@ -86,6 +86,55 @@ private:
     void cleanup();
 };
 
+// Small-block allocator for a Lua VM.  Blocks up to MAX_SIZE bytes are
+// rounded up to a multiple of GRAIN and carved out of large slabs, with a
+// free list per size; anything bigger goes to malloc.  Lua always tells
+// the allocator how big a block is when it frees or resizes it, so blocks
+// need no header.  Slabs are only given back when the pool is destroyed,
+// after the VM has been closed.
+class lua_pool
+{
+public:
+    lua_pool();
+    ~lua_pool();
+
+    void *allocate(size_t size);
+    void release(void *ptr, size_t size);
+    void *reallocate(void *ptr, size_t osize, size_t nsize);
+
+private:
+    static const size_t GRAIN = 8;
+    static const size_t MAX_SIZE = 512;
+    static const size_t NUM_CLASSES = MAX_SIZE / GRAIN;
+    static const size_t SLAB_SIZE = 64 * 1024;
+
+    static size_t size_class(size_t size) { return (size - 1) / GRAIN; }
+
+    void *free_list[NUM_CLASSES];
+    char *slab_next, *slab_end;
+    vector<char*> slabs;
+};
+
+// Calls made to one Lua hook or function, and the wall-clock time they
+// took, including anything they called in turn.
+struct lua_profile_entry
+{
+    lua_profile_entry()
+        : calls(0), total_usec(0), max_usec(0), turn(-1), turn_usec(0),
+          warned_turn(-1)
+    {
+    }
+
+    int calls;
+    double total_usec;
+    double max_usec;
+
+    // Time used so far in the current turn, for the lua_hook_budget option.
+    int turn;
+    double turn_usec;
+    int warned_turn;
+};
+
 class CLua
 {
 public:
@@ -142,6 +191,12 @@ public:
 
     static bool is_managed_vm(lua_State *ls);
 
+    void note_allocation();
+    int last_turn_allocs();
+
+    string profile_report() const;
+    void reset_profile();
+
     void print_stack();
 
 public:
@@ -160,7 +215,21 @@ public:
     int max_mixed_call_depth;
     int max_lua_call_depth;
 
+    lua_pool pool;
     long memory_used;
+    long memory_peak;
+
+    // Allocations made in total, in the current turn so far, and in the
+    // turn before it.
+    int n_allocs;
+    int turn_allocs, prev_turn_allocs, alloc_turn;
+
+    // Time spent in user scripts, by hook name and by the Lua function
+    // ("file:line") that ran.  Only kept for managed VMs, and only while
+    // the lua_profile or lua_hook_budget options ask for it.
+    typedef map<string, lua_profile_entry> lua_profile;
+    lua_profile hook_profile;
+    lua_profile fn_profile;
 
     static const int MAX_THROTTLE_SLEEPS = 100;
 
@@ -185,8 +254,10 @@ private:
 
     bool proc_returns(const char *par) const;
 
-    bool calltopfn(lua_State *ls, const char *format, va_list args,
-                   int retc = -1, va_list *fnr = NULL);
+    bool calltopfn(lua_State *ls, const char *fn, const char *format,
+                   va_list args, int retc = -1, va_list *fnr = NULL);
+    int profiled_pcall(lua_State *ls, const char *fn, int nargs, int nret);
+    void note_call_time(const char *hook, const string &fn, double usec);
     maybe_bool callmbooleanfn(const char *fn, const char *params,
                               va_list args);
 
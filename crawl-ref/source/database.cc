@@ -18,6 +18,7 @@
 #include "database.h"
 #include "errors.h"
 #include "files.h"
+#include "hashdb.h"
 #include "libutil.h"
 #include "options.h"
 #include "random.h"
@@ -38,11 +39,9 @@ public:
     ~TextDB() { shutdown(true); delete translation; }
     void init();
     void shutdown(bool recursive = false);
-    DBM* get() { return _db; }
+    const hash_db* get() const { return _db; }
 
-    // Make it easier to migrate from raw DBM* to TextDB
     operator bool() const { return _db != 0; }
-    operator DBM*() const { return _db; }
 
  private:
     bool _needs_update() const;
@@ -53,7 +52,7 @@ public:
     const char* const _db_name;
     string _directory;
     vector<string> _input_files;
-    DBM* _db;
+    hash_db* _db;
     string timestamp;
     TextDB *_parent;
     const char* lang() { return _parent ? Options.lang_name : 0; }
@@ -61,13 +60,12 @@ public:
     TextDB *translation;
 };
 
-// Convenience functions for (read-only) access to generic
-// berkeley DB databases.
-static void _store_text_db(const string &in, DBM *db);
+// Convenience functions for (read-only) access to the text databases.
+static void _store_text_db(const string &in, hash_db_writer &db);
 
 static string _query_database(TextDB &db, string key, bool canonicalise_key,
                               bool run_lua, bool untranslated = false);
-static void _add_entry(DBM *db, const string &k, string &v);
+static void _add_entry(hash_db_writer &db, const string &k, string &v);
 
 static TextDB AllDBs[] =
 {
@@ -156,6 +154,8 @@ static string _db_cache_path(string db, const char *lang)
     return savedir_versioned_path("db/" + db);
 }
 
+#define DB_SUFFIX ".hdb"
+
 // ----------------------------------------------------------------------
 // TextDB
 // ----------------------------------------------------------------------
@@ -193,10 +193,14 @@ bool TextDB::open_db()
     if (_db)
         return true;
 
-    const string full_db_path = _db_cache_path(_db_name, lang());
-    _db = dbm_open(full_db_path.c_str(), O_RDONLY, 0660);
-    if (!_db)
+    const string full_db_path = _db_cache_path(_db_name, lang()) + DB_SUFFIX;
+    _db = new hash_db;
+    if (!_db->open(full_db_path))
+    {
+        delete _db;
+        _db = NULL;
         return false;
+    }
 
     timestamp = _query_database(*this, "TIMESTAMP", false, false, true);
     if (timestamp.empty())
@@ -228,11 +232,8 @@ void TextDB::init()
 
 void TextDB::shutdown(bool recursive)
 {
-    if (_db)
-    {
-        dbm_close(_db);
-        _db = NULL;
-    }
+    delete _db;
+    _db = NULL;
     if (recursive && translation)
         translation->shutdown(recursive);
 }
@@ -279,7 +280,7 @@ void TextDB::_regenerate_db()
 #endif
 
     string db_path = _db_cache_path(_db_name, lang());
-    string full_db_path = db_path + ".db";
+    string full_db_path = db_path + DB_SUFFIX;
 
     {
         string output_dir = get_parent_directory(db_path);
@@ -288,13 +289,9 @@ void TextDB::_regenerate_db()
     }
 
     file_lock lock(db_path + ".lk", "wb");
-#ifndef DGL_REWRITE_PROTECT_DB_FILES
-    unlink_u(full_db_path.c_str());
-#endif
 
     string ts;
-    if (!(_db = dbm_open(db_path.c_str(), O_RDWR | O_CREAT, 0660)))
-        end(1, true, "Unable to open DB: %s", db_path.c_str());
+    hash_db_writer db;
     for (unsigned int i = 0; i < _input_files.size(); i++)
     {
         string full_input_path = _directory + _input_files[i];
@@ -304,12 +301,18 @@ void TextDB::_regenerate_db()
         snprintf(buf, sizeof(buf), ":%" PRId64, (int64_t)mtime);
         ts += buf;
         if (mtime || !_parent) // english is mandatory
-            _store_text_db(full_input_path, _db);
+            _store_text_db(full_input_path, db);
     }
-    _add_entry(_db, "TIMESTAMP", ts);
+    _add_entry(db, "TIMESTAMP", ts);
 
-    dbm_close(_db);
-    _db = 0;
+    // Processes that still have the old file mapped keep reading it; the
+    // new one only becomes visible once it is complete.
+    const string tmp_db_path = full_db_path + ".tmp";
+    if (!db.write(tmp_db_path)
+        || rename_u(tmp_db_path.c_str(), full_db_path.c_str()))
+    {
+        end(1, true, "Unable to write DB: %s", full_db_path.c_str());
+    }
 }
 
 // ----------------------------------------------------------------------
@@ -328,11 +331,6 @@ static void* init_db(void *arg)
 
 void databaseSystemInit()
 {
-    // Note: if you're building contrib libraries initially checked out
-    // before 2011-12-28 and this assertion fails, please make sure you have
-    // the current version ("git submodule sync;git submodule update --init").
-    ASSERT(sqlite3_threadsafe());
-
     thread_t th[NUM_DB];
     for (unsigned int i = 0; i < NUM_DB; i++)
 #ifndef DGAMELAUNCH
@@ -358,24 +356,15 @@ void databaseSystemShutdown()
 // Main DB functions
 
 
-static datum _database_fetch(DBM *database, const string &key)
+// Points val at the text stored under key.  Empty entries count as missing.
+static bool _database_fetch(const hash_db *database, const string &key,
+                            const char *&val, uint32_t &len)
 {
-    datum result;
-    result.dptr = NULL;
-    result.dsize = 0;
-    datum dbKey;
-
-    dbKey.dptr = (DPTR_COERCE) key.c_str();
-    dbKey.dsize = key.length();
-
     // Don't use the database if called from "monster".
-    if (database)
-        result = dbm_fetch(database, dbKey);
-
-    return result;
+    return database && database->fetch(key, val, len) && len > 0;
 }
 
-static vector<string> _database_find_keys(DBM *database,
+static vector<string> _database_find_keys(const hash_db *database,
                                           const string &regex,
                                           bool ignore_case,
                                           db_find_filter filter = NULL)
@@ -383,11 +372,9 @@ static vector<string> _database_find_keys(DBM *database,
     text_pattern             tpat(regex, ignore_case);
     vector<string> matches;
 
-    datum dbKey = dbm_firstkey(database);
-
-    while (dbKey.dptr != NULL)
+    for (uint32_t i = 0, size = database->size(); i < size; ++i)
     {
-        string key((const char *)dbKey.dptr, dbKey.dsize);
+        string key = database->key(i);
 
         if (tpat.matches(key)
             && key.find("__") == string::npos
@@ -395,14 +382,12 @@ static vector<string> _database_find_keys(DBM *database,
         {
             matches.push_back(key);
         }
-
-        dbKey = dbm_nextkey(database);
     }
 
     return matches;
 }
 
-static vector<string> _database_find_bodies(DBM *database,
+static vector<string> _database_find_bodies(const hash_db *database,
                                             const string &regex,
                                             bool ignore_case,
                                             db_find_filter filter = NULL)
@@ -410,14 +395,10 @@ static vector<string> _database_find_bodies(DBM *database,
     text_pattern             tpat(regex, ignore_case);
     vector<string> matches;
 
-    datum dbKey = dbm_firstkey(database);
-
-    while (dbKey.dptr != NULL)
+    for (uint32_t i = 0, size = database->size(); i < size; ++i)
     {
-        string key((const char *)dbKey.dptr, dbKey.dsize);
-
-        datum dbBody = dbm_fetch(database, dbKey);
-        string body((const char *)dbBody.dptr, dbBody.dsize);
+        string key = database->key(i);
+        string body = database->value(i);
 
         if (tpat.matches(body)
             && key.find("__") == string::npos
@@ -425,8 +406,6 @@ static vector<string> _database_find_bodies(DBM *database,
         {
             matches.push_back(key);
         }
-
-        dbKey = dbm_nextkey(database);
     }
 
     return matches;
@@ -473,21 +452,13 @@ static void _trim_leading_newlines(string &s)
     s.erase(0, s.find_first_not_of("\n"));
 }
 
-static void _add_entry(DBM *db, const string &k, string &v)
+static void _add_entry(hash_db_writer &db, const string &k, string &v)
 {
     _trim_leading_newlines(v);
-    datum key, value;
-    key.dptr = (char *) k.c_str();
-    key.dsize = k.length();
-
-    value.dptr = (char *) v.c_str();
-    value.dsize = v.length();
-
-    if (dbm_store(db, key, value, DBM_REPLACE))
-        end(1, true, "Error storing %s", k.c_str());
+    db.add(k, v);
 }
 
-static void _parse_text_db(LineInput &inf, DBM *db)
+static void _parse_text_db(LineInput &inf, hash_db_writer &db)
 {
     string key;
     string value;
@@ -530,7 +501,7 @@ static void _parse_text_db(LineInput &inf, DBM *db)
         _add_entry(db, key, value);
 }
 
-static void _store_text_db(const string &in, DBM *db)
+static void _store_text_db(const string &in, hash_db_writer &db)
 {
     UTF8FileLineInput inf(in.c_str());
     if (inf.error())
@@ -598,6 +569,18 @@ static string _chooseStrByWeight(string entry, int fixed_weight = -1)
     return "BUG, NO STRING CHOSEN";
 }
 
+// Looks key up in the translation first, if there is one.
+static bool _translated_fetch(TextDB &db, const string &key, bool untranslated,
+                              const char *&val, uint32_t &len)
+{
+    if (db.translation && !untranslated
+        && _database_fetch(db.translation->get(), key, val, len))
+    {
+        return true;
+    }
+    return _database_fetch(db.get(), key, val, len);
+}
+
 #define MAX_RECURSION_DEPTH 10
 #define MAX_REPLACEMENTS    100
 
@@ -610,31 +593,22 @@ static string _getWeightedString(TextDB &db, const string &key,
     lowercase(canonical_key);
 
     // Query the DB.
-    datum result;
+    const char *val;
+    uint32_t len;
 
-    if (db.translation)
-        result = _database_fetch(db.translation->get(), canonical_key);
-    if (result.dsize <= 0)
-        result = _database_fetch(db.get(), canonical_key);
-
-    if (result.dsize <= 0)
+    if (!_translated_fetch(db, canonical_key, false, val, len))
     {
         // Try ignoring the suffix.
         canonical_key = key;
         lowercase(canonical_key);
 
         // Query the DB.
-        if (db.translation)
-            result = _database_fetch(db.translation->get(), canonical_key);
-        if (result.dsize <= 0)
-            result = _database_fetch(db.get(), canonical_key);
-
-        if (result.dsize <= 0)
+        if (!_translated_fetch(db, canonical_key, false, val, len))
             return "";
     }
 
     // Cons up a (C++) string to return.  The caller must release it.
-    string str = string((const char *)result.dptr, result.dsize);
+    string str = string(val, len);
 
     return _chooseStrByWeight(str, fixed_weight);
 }
@@ -724,17 +698,13 @@ static string _query_database(TextDB &db, string key, bool canonicalise_key,
     }
 
     // Query the DB.
-    datum result;
-
-    if (db.translation && !untranslated)
-        result = _database_fetch(db.translation->get(), key);
-    if (result.dsize <= 0)
-        result = _database_fetch(db.get(), key);
+    const char *val;
+    uint32_t len;
 
-    if (result.dsize <= 0)
+    if (!_translated_fetch(db, key, untranslated, val, len))
         return "";
 
-    string str((const char *)result.dptr, result.dsize);
+    string str(val, len);
 
     // <foo> is an alias to key foo
     if (str[0] == '<' && str[str.size() - 2] == '>'
@@ -793,8 +763,7 @@ vector<string> getLongDescBodiesByRegex(const string &regex,
     // On partial translations, this will match only translated descriptions.
     // Not good, but otherwise we'd have to check hundreds of keys, with
     // two queries for each.
-    // SQL can do this in one go, DBM can't.
-    DBM *database = DescriptionDB.translation ?
+    const hash_db *database = DescriptionDB.translation ?
         DescriptionDB.translation->get() : DescriptionDB.get();
     return _database_find_bodies(database, regex, true, filter);
 }
@@ -10,6 +10,7 @@
 #include "branch.h"
 #include "chardump.h"
 #include "crash.h"
+#include "dlua.h"
 #include "dungeon.h"
 #include "env.h"
 #include "initfile.h"
@@ -271,6 +272,11 @@ static void _write_mapgen_stats()
             mg_levels_tried, mg_levels_tried - mg_levels_failed,
             mg_levels_failed);
 
+    int compiled, undumped, reused;
+    dlua_chunk_stats(compiled, undumped, reused);
+    fprintf(outf, "Lua chunks compiled: %d, loaded from bytecode: %d, "
+                  "reused: %d\n", compiled, undumped, reused);
+
     if (!mapgen_errors.empty())
     {
         fprintf(outf, "\n\nMap errors:\n");
@@ -130,6 +130,15 @@ void debug_item_scan(void)
         }
     }
 
+    // Every unused slot should be on the free list; one that isn't won't be
+    // handed out until get_mitm_slot() runs out and rebuilds the list.
+    int unlisted = 0;
+    for (i = 0; i < MAX_ITEMS; ++i)
+        if (!mitm[i].defined() && !env.free_items.get(i) && !unlisted++)
+            mprf(MSGCH_ERROR, "Unused item slot %d not on the free list", i);
+    if (unlisted > 1)
+        mprf(MSGCH_ERROR, "... and %d more unlisted item slots", unlisted - 1);
+
     // Now scan all the items on the level:
     for (i = 0; i < MAX_ITEMS; ++i)
     {
@@ -347,6 +356,24 @@ void debug_mons_scan()
     ASSERT(you.type == MONS_PLAYER);
     ASSERT(you.mid == MID_PLAYER);
 
+    int unlisted = 0;
+    for (int i = 0; i < MAX_MONSTERS; ++i)
+    {
+        if (menv[i].type == MONS_NO_MONSTER && !env.free_mons.get(i)
+            && !unlisted++)
+        {
+            _announce_level_prob(warned);
+            mprf(MSGCH_ERROR, "Unused monster slot %d not on the free list",
+                 i);
+            warned = true;
+        }
+    }
+    if (unlisted > 1)
+    {
+        mprf(MSGCH_ERROR, "... and %d more unlisted monster slots",
+             unlisted - 1);
+    }
+
     vector<int> floating_mons;
     bool             is_floating[MAX_MONSTERS];
 
@@ -9,6 +9,7 @@
 
 #include "artefact.h"
 #include "cio.h"
+#include "clua.h"
 #include "coord.h"
 #include "directn.h"
 #include "dungeon.h"
@@ -105,6 +106,13 @@ void debug_dump_levgen()
     mpr("");
 }
 
+void debug_dump_lua_profile()
+{
+    vector<string> lines = split_string("\n", clua.profile_report(), false);
+    for (unsigned int i = 0; i < lines.size(); ++i)
+        mprf_nocap("%s", lines[i].c_str());
+}
+
 string debug_coord_str(const coord_def &pos)
 {
     return make_stringf("(%d, %d)%s", pos.x, pos.y,
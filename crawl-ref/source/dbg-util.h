@@ -13,6 +13,7 @@ skill_type skill_from_name(const char *name);
 int debug_cap_stat(int stat);
 
 void debug_dump_levgen();
+void debug_dump_lua_profile();
 
 struct item_def;
 string debug_art_val_str(const item_def& item);
@@ -338,6 +338,31 @@ ClampLayout::operator()(const coord_def &p, const uint32_t offset) const
     return ProceduralSample(p, sample.feat(), cp);
 }
 
+CacheLayout::CacheLayout(const ProceduralLayout &_layout, int size_log2)
+    : layout(_layout), mask((1 << size_log2) - 1)
+{
+    cached_sample empty;
+    empty.ft = DNGN_UNSEEN;
+    cache.resize(mask + 1, empty);
+}
+
+ProceduralSample
+CacheLayout::operator()(const coord_def &p, const uint32_t offset) const
+{
+    cached_sample &slot(cache[hash3(p.x, p.y, offset) & mask]);
+    if (slot.ft == DNGN_UNSEEN || slot.p != p || slot.offset != offset)
+    {
+        const ProceduralSample sample = layout(p, offset);
+        slot.p = p;
+        slot.offset = offset;
+        slot.c = sample.coord();
+        slot.ft = sample.feat();
+        slot.cp = sample.changepoint();
+        slot.m = sample.mask();
+    }
+    return ProceduralSample(slot.c, slot.ft, slot.cp, slot.m);
+}
+
 ProceduralSample
 CityLayout::operator()(const coord_def &p, const uint32_t offset) const
 {
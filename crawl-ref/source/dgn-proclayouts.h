@@ -203,6 +203,31 @@ class ClampLayout : public ProceduralLayout
         const bool bursty;
 };
 
+// Remembers the samples of another layout, so that asking again for the
+// same point at the same offset costs a lookup instead of a trip through the
+// noise functions.  Layouts depend only on those two, so this never changes
+// what gets generated.  The cache is direct-mapped with 2^size_log2 slots.
+class CacheLayout : public ProceduralLayout
+{
+    public:
+        CacheLayout(const ProceduralLayout &_layout, int size_log2 = 14);
+        ProceduralSample operator()(const coord_def &p,
+            const uint32_t offset = 0) const;
+    private:
+        struct cached_sample
+        {
+            coord_def p;
+            uint32_t offset;
+            coord_def c;
+            dungeon_feature_type ft; // DNGN_UNSEEN for an empty slot
+            uint32_t cp;
+            map_mask_type m;
+        };
+        const ProceduralLayout &layout;
+        const uint32_t mask;
+        mutable vector<cached_sample> cache;
+};
+
 class CityLayout : public ProceduralLayout
 {
     public:
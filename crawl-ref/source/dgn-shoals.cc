@@ -1066,15 +1066,41 @@ static int _shoals_tide_at(coord_def pos, int base_tide)
     return base_tide + max(0, tide_called_peak - pos.range() * 3);
 }
 
-static vector<coord_def> _shoals_extra_tide_seeds()
+// Markers with tide_seed="y" on the current level.  Looking them up asks
+// every marker for its properties, so this is only done again when the tide
+// is forced, which happens on level creation and on arrival.
+static vector<coord_def> _shoals_extra_tide_seeds(bool refresh)
 {
-    return find_marker_positions_by_prop("tide_seed");
+    static level_id seed_level;
+    static vector<coord_def> seeds;
+
+    if (refresh || seed_level != level_id::current())
+    {
+        seeds = find_marker_positions_by_prop("tide_seed");
+        seed_level = level_id::current();
+    }
+    return seeds;
 }
 
-static void _shoals_apply_tide(int tide, bool incremental_tide)
+static void _shoals_apply_tide(int tide, bool incremental_tide,
+                               bool refresh_seeds)
 {
-    vector<coord_def> pages[2];
+    // Kept between calls, so that neither the pages nor the seen grid
+    // need rebuilding each time; a cell has been seen by this pass if it
+    // holds the current pass number.
+    static vector<coord_def> pages[2];
+    static FixedArray<unsigned int, GXM, GYM> seen_points(0);
+    static unsigned int pass = 0;
+
+    if (!++pass)
+    {
+        seen_points.init(0);
+        pass = 1;
+    }
+
     int current_page = 0;
+    pages[0].clear();
+    pages[1].clear();
 
     // Start from corners of the map.
     pages[current_page].push_back(coord_def(1,1));
@@ -1082,13 +1108,11 @@ static void _shoals_apply_tide(int tide, bool incremental_tide)
     pages[current_page].push_back(coord_def(1, GYM - 2));
     pages[current_page].push_back(coord_def(GXM - 2, GYM - 2));
 
-    // Find any extra seeds -- markers with tide_seed="y".
-    const vector<coord_def> extra_seeds(_shoals_extra_tide_seeds());
+    const vector<coord_def> extra_seeds(
+        _shoals_extra_tide_seeds(refresh_seeds));
     pages[current_page].insert(pages[current_page].end(),
                                extra_seeds.begin(), extra_seeds.end());
 
-    FixedArray<bool, GXM, GYM> seen_points(false);
-
     while (!pages[current_page].empty())
     {
         int next_page = !current_page;
@@ -1100,7 +1124,7 @@ static void _shoals_apply_tide(int tide, bool incremental_tide)
             coord_def c(cpage[i]);
             const dungeon_feature_type herefeat(grd(c));
             const bool was_wet(_shoals_tide_passable_feat(herefeat));
-            seen_points(c) = true;
+            seen_points(c) = pass;
             if (_shoals_tide_susceptible_feat(herefeat))
             {
                 _shoals_apply_tide_at(c, _shoals_tide_at(c, tide),
@@ -1120,14 +1144,14 @@ static void _shoals_apply_tide(int tide, bool incremental_tide)
                     coord_def adj(*ai);
                     if (!in_bounds(adj))
                         continue;
-                    if (!seen_points(adj))
+                    if (seen_points(adj) != pass)
                     {
                         const dungeon_feature_type feat = grd(adj);
                         if (_shoals_tide_passable_feat(feat)
                             || _shoals_tide_susceptible_feat(feat))
                         {
                             npage.push_back(adj);
-                            seen_points(adj) = true;
+                            seen_points(adj) = pass;
                         }
                         // Squares that the tide cannot directly
                         // affect may still lose bloodspatter as the
@@ -1224,7 +1248,7 @@ void shoals_apply_tides(int turns_elapsed, bool force, bool incremental_tide)
     {
         _shoals_tide_direction =
             tide > old_tide ? TIDE_RISING : TIDE_FALLING;
-        _shoals_apply_tide(tide / TIDE_MULTIPLIER, incremental_tide);
+        _shoals_apply_tide(tide / TIDE_MULTIPLIER, incremental_tide, force);
     }
 }
 
@@ -1263,7 +1287,7 @@ static void _shoals_force_tide(CrawlHashTable &props, int increment)
     tide = min(HIGH_TIDE, max(LOW_TIDE, tide));
     props[PROPS_SHOALS_TIDE_KEY] = short(tide);
     _shoals_tide_direction = increment > 0 ? TIDE_RISING : TIDE_FALLING;
-    _shoals_apply_tide(tide / TIDE_MULTIPLIER, false);
+    _shoals_apply_tide(tide / TIDE_MULTIPLIER, false, true);
 }
 
 void wizard_mod_tide()
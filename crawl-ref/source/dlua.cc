@@ -20,6 +20,38 @@ static int dlua_compiled_chunk_writer(lua_State *ls, const void *p,
     return 0;
 }
 
+// Functions loaded from compiled chunks, keyed by their bytecode.  Map
+// chunks are loaded afresh for every placement attempt, and undumping
+// the same vault's Lua again each time adds up.  The table has weak
+// values, so functions that haven't been run lately are collected as
+// usual.
+#define DLUA_CHUNK_CACHE "__dlua_chunks"
+
+static int chunks_compiled = 0, chunks_undumped = 0, chunks_reused = 0;
+
+void dlua_chunk_stats(int &compiled, int &undumped, int &reused)
+{
+    compiled = chunks_compiled;
+    undumped = chunks_undumped;
+    reused   = chunks_reused;
+}
+
+static void _push_chunk_cache(lua_State *ls)
+{
+    lua_getfield(ls, LUA_REGISTRYINDEX, DLUA_CHUNK_CACHE);
+    if (lua_istable(ls, -1))
+        return;
+
+    lua_pop(ls, 1);
+    lua_newtable(ls);
+    lua_newtable(ls);
+    lua_pushstring(ls, "v");
+    lua_setfield(ls, -2, "__mode");
+    lua_setmetatable(ls, -2);
+    lua_pushvalue(ls, -1);
+    lua_setfield(ls, LUA_REGISTRYINDEX, DLUA_CHUNK_CACHE);
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // dlua_chunk
 
@@ -146,12 +178,47 @@ int dlua_chunk::check_op(CLua &interp, int err)
     return err;
 }
 
+int dlua_chunk::load_compiled(CLua &interp)
+{
+    lua_State *ls = interp;
+    _push_chunk_cache(ls);
+    lua_pushlstring(ls, compiled.data(), compiled.length());
+    lua_rawget(ls, -2);
+    if (lua_isfunction(ls, -1))
+    {
+        // The last run may have left the map environment on it; start
+        // over in the globals, as a freshly loaded chunk would.
+        lua_pushvalue(ls, LUA_GLOBALSINDEX);
+        lua_setfenv(ls, -2);
+        lua_remove(ls, -2);
+        ++chunks_reused;
+        error.clear();
+        return 0;
+    }
+    lua_pop(ls, 1);
+
+    const int err = check_op(interp,
+                             interp.loadbuffer(compiled.c_str(),
+                                               compiled.length(),
+                                               context.c_str()));
+    if (err)
+    {
+        lua_pop(ls, 1);
+        return err;
+    }
+    ++chunks_undumped;
+
+    lua_pushlstring(ls, compiled.data(), compiled.length());
+    lua_pushvalue(ls, -2);
+    lua_rawset(ls, -4);
+    lua_remove(ls, -2);
+    return 0;
+}
+
 int dlua_chunk::load(CLua &interp)
 {
     if (!compiled.empty())
-        return check_op(interp,
-                         interp.loadbuffer(compiled.c_str(), compiled.length(),
-                                           context.c_str()));
+        return load_compiled(interp);
 
     if (empty())
     {
@@ -163,6 +230,7 @@ int dlua_chunk::load(CLua &interp)
                         interp.loadstring(chunk.c_str(), context.c_str()));
     if (err)
         return err;
+    ++chunks_compiled;
     ostringstream out;
     err = lua_dump(interp, dlua_compiled_chunk_writer, &out);
     if (err)
@@ -39,6 +39,7 @@ private:
 
 private:
     int check_op(CLua &, int);
+    int load_compiled(CLua &);
     string rewrite_chunk_prefix(const string &line, bool skip_body = false) const;
     string get_chunk_prefix(const string &s) const;
 
@@ -74,5 +75,6 @@ public:
 };
 
 void init_dungeon_lua();
+void dlua_chunk_stats(int &compiled, int &undumped, int &reused);
 
 #endif
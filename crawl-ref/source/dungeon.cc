@@ -697,53 +697,96 @@ static bool _dgn_square_is_passable(const coord_def &c)
     return !(env.level_map_mask(c) & MMT_OPAQUE) && dgn_square_travel_ok(c);
 }
 
-static inline void _dgn_point_record_stub(const coord_def &) { }
-
-template <class point_record>
-static bool _dgn_fill_zone(
-    const coord_def &start, int zone,
-    point_record &record_point,
-    bool (*passable)(const coord_def &) = _dgn_square_is_passable,
-    bool (*iswanted)(const coord_def &) = NULL)
+static bool _dgn_square_is_traversable(const coord_def &c)
 {
-    bool ret = false;
-    list<coord_def> points[2];
-    int cur = 0;
+    // Whatever travel can cross, with traps thrown in.
+    const dungeon_feature_type feat = grd(c);
+    return feat_is_traversable(feat) || feat_is_trap(feat);
+}
 
-    // No bounds checks, assuming the level has at least one layer of
-    // rock border.
+// Union-find forest for _dgn_label_zones: each provisional label points
+// at a smaller one of the same zone, or at itself if it is the root.
+static vector<int> _zone_parent;
 
-    for (points[cur].push_back(start); !points[cur].empty();)
+static int _zone_root(int zone)
+{
+    while (_zone_parent[zone] != zone)
     {
-        for (list<coord_def>::const_iterator i = points[cur].begin();
-             i != points[cur].end(); ++i)
-        {
-            const coord_def &c(*i);
+        _zone_parent[zone] = _zone_parent[_zone_parent[zone]];
+        zone = _zone_parent[zone];
+    }
+    return zone;
+}
+
+static int _zone_join(int a, int b)
+{
+    a = _zone_root(a);
+    b = _zone_root(b);
+    if (a < b)
+        _zone_parent[b] = a;
+    else
+        _zone_parent[a] = b;
+    return min(a, b);
+}
 
-            travel_point_distance[c.x][c.y] = zone;
+// Labels the 8-connected zones of squares that pass the given test, with
+// one scan over the map to link up provisional labels and one to replace
+// them with their zone's number.  Zones are numbered from 1 in the order
+// their first square comes up scanning rows top to bottom, which is the
+// order a flood fill from each unlabelled square in turn would give them.
+// Squares outside the zones (including those within border of the edge of
+// the map) are set to 0.  Returns the number of zones.
+template <class zone_grid, class pred>
+static int _dgn_label_zones(zone_grid &zones, pred &passable, int border = 0)
+{
+    _zone_parent.assign(1, 0);
 
-            if (iswanted && iswanted(c))
-                ret = true;
+    for (int y = 0; y < GYM; ++y)
+        for (int x = 0; x < GXM; ++x)
+        {
+            if (x < border || x >= GXM - border
+                || y < border || y >= GYM - border
+                || !passable(coord_def(x, y)))
+            {
+                zones[x][y] = 0;
+                continue;
+            }
 
-            for (adjacent_iterator ai(c); ai; ++ai)
+            // The west, north-west, north and north-east neighbours have
+            // been seen already.
+            static const int dx[4] = { -1, -1, 0, 1 };
+            static const int dy[4] = {  0, -1, -1, -1 };
+            int zone = 0;
+            for (int i = 0; i < 4; ++i)
             {
-                const coord_def& cp = *ai;
-                if (!map_bounds(cp)
-                    || travel_point_distance[cp.x][cp.y] || !passable(cp))
-                {
+                const int nx = x + dx[i], ny = y + dy[i];
+                if (nx < 0 || nx >= GXM || ny < 0 || !zones[nx][ny])
                     continue;
-                }
-
-                travel_point_distance[cp.x][cp.y] = zone;
-                record_point(cp);
-                points[!cur].push_back(cp);
+                zone = zone ? _zone_join(zone, zones[nx][ny]) : zones[nx][ny];
+            }
+            if (!zone)
+            {
+                zone = _zone_parent.size();
+                _zone_parent.push_back(zone);
             }
+            zones[x][y] = zone;
         }
 
-        points[cur].clear();
-        cur = !cur;
+    // Roots are the smallest label in their zone, so they come before the
+    // rest of it and get numbered first.
+    vector<int> number(_zone_parent.size(), 0);
+    int nzones = 0;
+    for (int i = 1, size = _zone_parent.size(); i < size; ++i)
+    {
+        const int root = _zone_root(i);
+        number[i] = root == i ? ++nzones : number[root];
     }
-    return ret;
+
+    for (int y = 0; y < GYM; ++y)
+        for (int x = 0; x < GXM; ++x)
+            zones[x][y] = number[zones[x][y]];
+
+    return nzones;
 }
 
 static bool _is_perm_down_stair(const coord_def &c)
@@ -881,69 +924,50 @@ static bool _is_exit_stair(const coord_def &c)
 //
 // If fill is non-zero, it fills any disconnected regions with fill.
 //
-static int _process_disconnected_zones(int x1, int y1, int x2, int y2,
-                                       bool choose_stairless,
+static int _process_disconnected_zones(bool choose_stairless,
                                        dungeon_feature_type fill)
 {
-    memset(travel_point_distance, 0, sizeof(travel_distance_grid_t));
-    int nzones = 0;
+    const int nzones = _dgn_label_zones(travel_point_distance,
+                                        _dgn_square_is_passable);
+
+    bool (*iswanted)(const coord_def &) =
+        !choose_stairless  ? NULL :
+        at_branch_bottom() ? _is_upwards_exit_stair
+                           : _is_exit_stair;
+
+    // Which zones have an exit stair, and which are connected to vaults.
+    vector<bool> has_exit(nzones + 1, false);
+    vector<bool> in_vault(nzones + 1, false);
+    for (rectangle_iterator ri(0); ri; ++ri)
+    {
+        const int zone = travel_point_distance[ri->x][ri->y];
+        if (!zone)
+            continue;
+
+        if (iswanted && !has_exit[zone] && iswanted(*ri))
+            has_exit[zone] = true;
+        if (fill && map_masked(*ri, MMT_VAULT))
+            in_vault[zone] = true;
+    }
+
+    // If we want only stairless zones, screen out zones that did have
+    // stairs.
     int ngood = 0;
-    for (int y = y1; y <= y2 ; ++y)
+    for (int zone = 1; zone <= nzones; ++zone)
+        if (has_exit[zone])
+            ++ngood;
+
+    if (fill)
     {
-        for (int x = x1; x <= x2; ++x)
+        // Don't fill in areas connected to vaults.
+        // We want vaults to be accessible; if the area is disconneted
+        // from the rest of the level, this will cause the level to be
+        // vetoed later on.
+        for (rectangle_iterator ri(0); ri; ++ri)
         {
-            if (!map_bounds(x, y)
-                || travel_point_distance[x][y]
-                || !_dgn_square_is_passable(coord_def(x, y)))
-            {
-                continue;
-            }
-
-            const bool found_exit_stair =
-                _dgn_fill_zone(coord_def(x, y), ++nzones,
-                               _dgn_point_record_stub,
-                               _dgn_square_is_passable,
-                               choose_stairless ? (at_branch_bottom() ?
-                                                   _is_upwards_exit_stair :
-                                                   _is_exit_stair) : NULL);
-
-            // If we want only stairless zones, screen out zones that did
-            // have stairs.
-            if (choose_stairless && found_exit_stair)
-                ++ngood;
-            else if (fill)
-            {
-                // Don't fill in areas connected to vaults.
-                // We want vaults to be accessible; if the area is disconneted
-                // from the rest of the level, this will cause the level to be
-                // vetoed later on.
-                bool veto = false;
-                vector<coord_def> coords;
-                for (int fy = y1; fy <= y2 ; ++fy)
-                {
-                    for (int fx = x1; fx <= x2; ++fx)
-                    {
-                        if (travel_point_distance[fx][fy] == nzones)
-                        {
-                            if (map_masked(coord_def(fx, fy), MMT_VAULT))
-                            {
-                                veto = true;
-                                break;
-                            }
-                            else
-                                coords.push_back(coord_def(fx, fy));
-                        }
-                    }
-                    if (veto)
-                        break;
-                }
-                if (!veto)
-                    for (vector<coord_def>::iterator it = coords.begin();
-                         it != coords.end(); it++)
-                    {
-                        _set_grd(*it, fill);
-                    }
-            }
+            const int zone = travel_point_distance[ri->x][ri->y];
+            if (zone && !has_exit[zone] && !in_vault[zone])
+                _set_grd(*ri, fill);
         }
     }
 
@@ -953,8 +977,7 @@ static int _process_disconnected_zones(int x1, int y1, int x2, int y2,
 int dgn_count_disconnected_zones(bool choose_stairless,
                                  dungeon_feature_type fill)
 {
-    return _process_disconnected_zones(0, 0, GXM-1, GYM-1, choose_stairless,
-                                       fill);
+    return _process_disconnected_zones(choose_stairless, fill);
 }
 
 static void _fixup_hell_stairs()
@@ -1138,39 +1161,43 @@ static coord_def _find_level_feature(int feat)
     return coord_def(0, 0);
 }
 
-static bool _has_connected_stone_stairs_from(const coord_def &c)
+static bool _is_downstair_or_hatch(dungeon_feature_type feat)
 {
-    flood_find<feature_grid, coord_predicate> ff(env.grid, in_bounds);
-    ff.add_feat(DNGN_STONE_STAIRS_DOWN_I);
-    ff.add_feat(DNGN_STONE_STAIRS_DOWN_II);
-    ff.add_feat(DNGN_STONE_STAIRS_DOWN_III);
-    ff.add_feat(DNGN_STONE_STAIRS_UP_I);
-    ff.add_feat(DNGN_STONE_STAIRS_UP_II);
-    ff.add_feat(DNGN_STONE_STAIRS_UP_III);
-
-    coord_def where = ff.find_first_from(c, env.level_map_mask);
-    return where.x || !ff.did_leave_vault();
+    switch (feat)
+    {
+    case DNGN_STONE_STAIRS_DOWN_I:
+    case DNGN_STONE_STAIRS_DOWN_II:
+    case DNGN_STONE_STAIRS_DOWN_III:
+    case DNGN_ESCAPE_HATCH_DOWN:
+        return true;
+    default:
+        return false;
+    }
 }
 
-static bool _has_connected_downstairs_from(const coord_def &c)
+// Labels the traversable zones of the level in travel_point_distance, and
+// notes which of them have a feature that isfeat accepts.
+static void _label_zones_with_feat(vector<bool> &has_feat,
+                                   bool (*isfeat)(dungeon_feature_type))
 {
-    flood_find<feature_grid, coord_predicate> ff(env.grid, in_bounds);
-    ff.add_feat(DNGN_STONE_STAIRS_DOWN_I);
-    ff.add_feat(DNGN_STONE_STAIRS_DOWN_II);
-    ff.add_feat(DNGN_STONE_STAIRS_DOWN_III);
-    ff.add_feat(DNGN_ESCAPE_HATCH_DOWN);
-
-    coord_def where = ff.find_first_from(c, env.level_map_mask);
-    return where.x || !ff.did_leave_vault();
+    const int nzones = _dgn_label_zones(travel_point_distance,
+                                        _dgn_square_is_traversable, 1);
+    has_feat.assign(nzones + 1, false);
+    for (rectangle_iterator ri(1); ri; ++ri)
+        if (isfeat(grd(*ri)))
+            has_feat[travel_point_distance[ri->x][ri->y]] = true;
+    has_feat[0] = false;
 }
 
 static bool _is_level_stair_connected(dungeon_feature_type feat)
 {
     coord_def up = _find_level_feature(feat);
-    if (up.x && up.y)
-        return _has_connected_downstairs_from(up);
+    if (!up.x || !up.y)
+        return false;
 
-    return false;
+    vector<bool> has_downstairs;
+    _label_zones_with_feat(has_downstairs, _is_downstair_or_hatch);
+    return has_downstairs[travel_point_distance[up.x][up.y]];
 }
 
 static bool _valid_dungeon_level()
@@ -1244,7 +1271,7 @@ void dgn_reset_level(bool enable_random_maps)
 
     const cloud_struct empty;
     env.cloud.init(empty);
-    env.cloud_no = 0;
+    rebuild_cloud_lists();
 
     mgrd.init(NON_MONSTER);
     igrd.init(NON_ITEM);
@@ -1732,86 +1759,71 @@ static bool _fixup_stone_stairs(bool preserve_vault_stairs)
 static bool _add_feat_if_missing(bool (*iswanted)(const coord_def &),
                                  dungeon_feature_type feat)
 {
-    memset(travel_point_distance, 0, sizeof(travel_distance_grid_t));
-    int nzones = 0;
-    for (int y = 0; y < GYM; ++y)
-        for (int x = 0; x < GXM; ++x)
-        {
-            // [ds] Use dgn_square_is_passable instead of
-            // dgn_square_travel_ok here, for we'll otherwise
-            // fail on floorless isolated pocket in vaults (like the
-            // altar surrounded by deep water), and trigger the assert
-            // downstairs.
-            const coord_def gc(x, y);
-            if (!map_bounds(x, y)
-                || travel_point_distance[x][y] // already covered previously
-                || !_dgn_square_is_passable(gc))
-            {
-                continue;
-            }
+    // [ds] Use dgn_square_is_passable instead of
+    // dgn_square_travel_ok here, for we'll otherwise
+    // fail on floorless isolated pocket in vaults (like the
+    // altar surrounded by deep water), and trigger the assert
+    // downstairs.
+    const int nzones = _dgn_label_zones(travel_point_distance,
+                                        _dgn_square_is_passable);
 
-            if (_dgn_fill_zone(gc, ++nzones, _dgn_point_record_stub,
-                               _dgn_square_is_passable, iswanted))
-            {
-                continue;
-            }
+    // Zones that already have what we want, or the feature itself.
+    vector<bool> has_feat(nzones + 1, false);
+    for (rectangle_iterator ri(0); ri; ++ri)
+    {
+        const int zone = travel_point_distance[ri->x][ri->y];
+        if (zone && !has_feat[zone] && (iswanted(*ri) || grd(*ri) == feat))
+            has_feat[zone] = true;
+    }
 
-            bool found_feature = false;
-            for (rectangle_iterator ri(0); ri; ++ri)
-            {
-                if (grd(*ri) == feat
-                    && travel_point_distance[ri->x][ri->y] == nzones)
-                {
-                    found_feature = true;
-                    break;
-                }
-            }
+    for (int nzone = 1; nzone <= nzones; ++nzone)
+    {
+        if (has_feat[nzone])
+            continue;
 
-            if (found_feature)
+        bool found_feature = false;
+        int i = 0;
+        while (i++ < 2000)
+        {
+            coord_def rnd(random2(GXM), random2(GYM));
+            if (grd(rnd) != DNGN_FLOOR)
                 continue;
 
-            int i = 0;
-            while (i++ < 2000)
-            {
-                coord_def rnd(random2(GXM), random2(GYM));
-                if (grd(rnd) != DNGN_FLOOR)
-                    continue;
+            if (travel_point_distance[rnd.x][rnd.y] != nzone)
+                continue;
 
-                if (travel_point_distance[rnd.x][rnd.y] != nzones)
-                    continue;
+            _set_grd(rnd, feat);
+            found_feature = true;
+            break;
+        }
 
-                _set_grd(rnd, feat);
-                found_feature = true;
-                break;
-            }
+        if (found_feature)
+            continue;
 
-            if (found_feature)
+        for (rectangle_iterator ri(0); ri; ++ri)
+        {
+            if (grd(*ri) != DNGN_FLOOR)
                 continue;
 
-            for (rectangle_iterator ri(0); ri; ++ri)
-            {
-                if (grd(*ri) != DNGN_FLOOR)
-                    continue;
-
-                if (travel_point_distance[ri->x][ri->y] != nzones)
-                    continue;
+            if (travel_point_distance[ri->x][ri->y] != nzone)
+                continue;
 
-                _set_grd(*ri, feat);
-                found_feature = true;
-                break;
-            }
+            _set_grd(*ri, feat);
+            found_feature = true;
+            break;
+        }
 
-            if (found_feature)
-                continue;
+        if (found_feature)
+            continue;
 
 #ifdef DEBUG_DIAGNOSTICS
-            dump_map("debug.map", true, true);
+        dump_map("debug.map", true, true);
 #endif
-            // [ds] Too many normal cases trigger this ASSERT, including
-            // rivers that surround a stair with deep water.
-            // die("Couldn't find region.");
-            return false;
-        }
+        // [ds] Too many normal cases trigger this ASSERT, including
+        // rivers that surround a stair with deep water.
+        // die("Couldn't find region.");
+        return false;
+    }
 
     return true;
 }
@@ -1852,11 +1864,14 @@ static bool _branch_entrances_are_connected()
 {
     // Returns true if all branch entrances on the level are connected to
     // stone stairs.
+    vector<bool> has_stairs;
     for (rectangle_iterator ri(0); ri; ++ri)
     {
         if (!feat_is_branch_stairs(grd(*ri)))
             continue;
-        if (!_has_connected_stone_stairs_from(*ri))
+        if (has_stairs.empty())
+            _label_zones_with_feat(has_stairs, feat_is_stone_stair);
+        if (!has_stairs[travel_point_distance[ri->x][ri->y]])
             return false;
     }
 
@@ -2792,13 +2807,6 @@ struct map_component
 {
     int label;
 
-    map_component()
-    {
-        min_equivalent = NULL;
-    }
-    map_component * min_equivalent;
-
-
     coord_def min_coord;
     coord_def max_coord;
 
@@ -2811,7 +2819,6 @@ struct map_component
         max_coord = pos;
 
         label = in_label;
-        min_equivalent = NULL;
     }
 
     void add_coord(const coord_def & pos)
@@ -2825,119 +2832,31 @@ struct map_component
         if (pos.y > max_coord.y)
             max_coord.y = pos.y;
     }
-
-    void merge_region(const map_component & existing)
-    {
-        add_coord(existing.min_coord);
-        add_coord(existing.max_coord);
-    }
 };
 
-static int _min_transitive_label(map_component & component)
-{
-    map_component * current = &component;
-
-    int label;
-    do
-    {
-        label = current->label;
-
-        current = current->min_equivalent;
-    } while (current);
-
-    return label;
-}
-
 // 8-way connected component analysis on the current level map.
 template<typename comp>
 static void _ccomps_8(FixedArray<int, GXM, GYM > & connectivity_map,
                       vector<map_component> & components, comp & connected)
 {
-    map<int, map_component> intermediate_components;
-
-    connectivity_map.init(0);
-    components.clear();
-
-    unsigned adjacent_size = 4;
-    coord_def offsets[4] = {coord_def(-1, 0), coord_def(-1, -1), coord_def(0, -1), coord_def(1, -1)};
-
-    int next_label = 1;
-
+    components.resize(_dgn_label_zones(connectivity_map, connected, 1));
 
-    // Pass 1, for each point, check the upper/left adjacent squares for labels
-    // if a labels are found, use the min connected label, else assign a new
-    // label and start a new component
+    // Zones are numbered in scan order, so the first square seen of each
+    // one starts it.
+    int seen = 0;
     for (rectangle_iterator pos(1); pos; ++pos)
     {
-        if (connected(*pos))
-        {
-            int absolute_min_label = INT_MAX;
-            set<int> neighbor_labels;
-            for (unsigned i = 0; i < adjacent_size; i++)
-            {
-                coord_def test = *pos + offsets[i];
-                if (in_bounds(test) && connectivity_map(test) != 0)
-                {
-                    int neighbor_label = connectivity_map(test);
-                    if (neighbor_labels.insert(neighbor_label).second)
-                    {
-                        int trans = _min_transitive_label(intermediate_components[neighbor_label]);
-
-                        if (trans < absolute_min_label)
-                            absolute_min_label = trans;
-                    }
-                }
-            }
-
-            int label;
-            if (neighbor_labels.empty())
-            {
-                intermediate_components[next_label].start_component(*pos, next_label);
-                label = next_label;
-                next_label++;
-            }
-            else
-            {
-                label = absolute_min_label;
-                map_component * absolute_min = &intermediate_components[absolute_min_label];
-
-                absolute_min->add_coord(*pos);
-                for (set<int>::iterator i = neighbor_labels.begin();
-                     i != neighbor_labels.end();i++)
-                {
-                    map_component * current = &intermediate_components[*i];
-
-                    while (current && current != absolute_min)
-                    {
-                        absolute_min->merge_region(*current);
-                        map_component * next = current->min_equivalent;
-                        current->min_equivalent = absolute_min;
-                        current = next;
-                    }
-                }
-            }
-            connectivity_map(*pos) = label;
-        }
-    }
+        const int label = connectivity_map(*pos);
+        if (!label)
+            continue;
 
-    int reindexed_label = 1;
-    // Reindex root labels, and move them to output
-    for (map<int, map_component>::iterator i = intermediate_components.begin();
-         i != intermediate_components.end(); ++i)
-    {
-        if (i->second.min_equivalent == NULL)
+        if (label > seen)
         {
-            i->second.label = reindexed_label++;
-            components.push_back(i->second);
+            seen = label;
+            components[label - 1].start_component(*pos, label);
         }
-    }
-
-    // Pass 2, mark new labels on the grid
-    for (rectangle_iterator pos(1); pos; ++pos)
-    {
-        int label = connectivity_map(*pos);
-        if (label  != 0)
-            connectivity_map(*pos) = _min_transitive_label(intermediate_components[label]);
+        else
+            components[label - 1].add_coord(*pos);
     }
 }
 
@@ -4197,7 +4116,7 @@ static const vault_placement *_build_vault_impl(const map_def *vault,
     if (!build_only && (placed_vault_orientation != MAP_ENCOMPASS || is_layout)
         && player_in_branch(BRANCH_SWAMP))
     {
-        _process_disconnected_zones(0, 0, GXM-1, GYM-1, true, DNGN_MANGROVE);
+        _process_disconnected_zones(true, DNGN_MANGROVE);
     }
 
     if (!make_no_exits)
@@ -6352,20 +6271,7 @@ static bool _fixup_interlevel_connectivity()
     has_down[0] = has_down[1] = has_down[2] = false;
 
     // Find up stairs and down stairs on the current level.
-    memset(travel_point_distance, 0, sizeof(travel_distance_grid_t));
-    int nzones = 0;
-    for (rectangle_iterator ri(0); ri; ++ri)
-    {
-        if (!map_bounds(ri->x, ri->y)
-            || travel_point_distance[ri->x][ri->y]
-            || !dgn_square_travel_ok(*ri))
-        {
-            continue;
-        }
-
-        _dgn_fill_zone(*ri, ++nzones, _dgn_point_record_stub,
-                       dgn_square_travel_ok, NULL);
-    }
+    _dgn_label_zones(travel_point_distance, dgn_square_travel_ok);
 
     int max_region = 0;
     for (rectangle_iterator ri(0); ri; ++ri)
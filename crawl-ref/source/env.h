@@ -1,6 +1,7 @@
 #ifndef ENV_H
 #define ENV_H
 
+#include "bitary.h"
 #include "map_knowledge.h"
 #include "monster.h"
 #include "trap_def.h"
@@ -25,6 +26,12 @@ struct crawl_environment
     FixedVector< item_def, MAX_ITEMS >       item;  // item list
     FixedVector< monster, MAX_MONSTERS+2 >   mons;  // monster list, plus anon
 
+    // Unused slots of item and mons.  A slot is put back when it is cleared,
+    // and only comes off once get_mitm_slot() or get_free_monster() finds
+    // it in use.
+    FreeSlotMap<MAX_ITEMS>                   free_items;
+    FreeSlotMap<MAX_MONSTERS>                free_mons;
+
     feature_grid                             grid;  // terrain grid
     FixedArray<terrain_property_t, GXM, GYM> pgrid; // terrain properties
     FixedArray< unsigned short, GXM, GYM >   mgrid; // monster grid
@@ -73,6 +80,11 @@ struct crawl_environment
 
     FixedVector< cloud_struct, MAX_CLOUDS >  cloud; // cloud list
     short cloud_no;
+    // The first cloud_no entries are the indices of the defined clouds, in
+    // no particular order; cloud_slot says where each of them is listed.
+    FixedVector< short, MAX_CLOUDS >         active_clouds;
+    FixedVector< short, MAX_CLOUDS >         cloud_slot;
+    FreeSlotMap<MAX_CLOUDS>                  free_clouds;
 
     FixedVector< shop_struct, MAX_SHOPS >    shop;  // shop list
     FixedVector< trap_def, MAX_TRAPS >       trap;  // trap list
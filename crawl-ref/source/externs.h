@@ -564,10 +564,7 @@ public:
 
     bool launched_by(const item_def &launcher) const;
 
-    void clear()
-    {
-        *this = item_def();
-    }
+    void clear();
 
     // Sets this item as being held by a given monster.
     void set_holding_monster(int midx);
@@ -593,6 +590,9 @@ public:
 private:
     string name_aux(description_level_type desc, bool terse, bool ident,
                     bool with_inscription, iflags_t ignore_flags) const;
+    string cached_name_aux(description_level_type desc, bool terse,
+                           bool ident, bool with_inscription,
+                           iflags_t ignore_flags) const;
 };
 
 typedef item_def item_info;
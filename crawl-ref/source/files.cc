@@ -106,6 +106,9 @@ static bool _ghost_version_compatible(reader &ghost_reader);
 
 static bool _restore_tagged_chunk(package *save, const string name,
                                   tag_type tag, const char* complaint);
+static bool _restore_tagged_reader(reader &inf, const string name,
+                                   tag_type tag, const char* complaint);
+static void _restore_level(const string &level_name);
 static bool _read_char_chunk(package *save);
 
 const short GHOST_SIGNATURE = short(0xDC55);
@@ -586,7 +589,20 @@ static bool _readln(chunk_reader &rd, char *buf)
     return true;
 }
 
-static void _fill_player_doll(player_save_info &p, package *save)
+// Reads the raw doll description stored in the "tdl" chunk, if any.
+static string _read_doll_line(package *save)
+{
+    if (!save->has_chunk("tdl"))
+        return "";
+
+    chunk_reader fdoll(save, "tdl");
+    char fbuf[LINEMAX];
+    if (!_readln(fdoll, fbuf))
+        return "";
+    return fbuf;
+}
+
+static void _fill_player_doll(player_save_info &p, const string &doll_line)
 {
     dolls_data equip_doll;
     for (unsigned int j = 0; j < TILEP_PART_MAX; ++j)
@@ -595,20 +611,15 @@ static void _fill_player_doll(player_save_info &p, package *save)
     equip_doll.parts[TILEP_PART_BASE]
         = tilep_species_to_base_tile(p.species, p.experience_level);
 
-    bool success = false;
-
-    chunk_reader fdoll(save, "tdl");
+    if (!doll_line.empty())
     {
         char fbuf[LINEMAX];
-        if (_readln(fdoll,fbuf))
-        {
-            tilep_scan_parts(fbuf, equip_doll, p.species, p.experience_level);
-            tilep_race_default(p.species, p.experience_level, &equip_doll);
-            success = true;
-        }
+        strncpy(fbuf, doll_line.c_str(), LINEMAX - 1);
+        fbuf[LINEMAX - 1] = 0;
+        tilep_scan_parts(fbuf, equip_doll, p.species, p.experience_level);
+        tilep_race_default(p.species, p.experience_level, &equip_doll);
     }
-
-    if (!success) // Use default doll instead.
+    else // Use default doll instead.
     {
         job_type job = get_job_by_name(p.class_name.c_str());
         if (job == JOB_UNKNOWN)
@@ -620,6 +631,232 @@ static void _fill_player_doll(player_save_info &p, package *save)
 }
 #endif
 
+/*
+ * The save index caches the player_save_info of every save in a save
+ * directory, so that listing characters does not have to open and inflate
+ * each package.  Entries are keyed by save file name and stamped with the
+ * file's size and modification time; a save whose stamp no longer matches
+ * is rescanned.  The whole index is thrown away when the version changes,
+ * since whether a save is loadable depends on the reading binary.
+ */
+#define SAVE_INDEX_FILE "saves.idx"
+// Bump when the entry layout changes.  Never 0: indexes written before
+// it existed have the high byte of the entry count there.
+#define SAVE_INDEX_FORMAT 1
+
+struct save_index_entry
+{
+    save_index_entry() : mtime(0), size(0), has_doll(false) { }
+
+    int64_t mtime;
+    int64_t size;
+    player_save_info info;
+    bool has_doll;      // whether doll was read; only with tile_menu_icons
+    string doll;        // raw "tdl" line, only used by tiles builds
+};
+
+typedef map<string, save_index_entry> save_index;
+
+static bool _save_stamp(const string &path, save_index_entry &entry)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st))
+        return false;
+
+    entry.mtime = st.st_mtime;
+    entry.size  = st.st_size;
+    return true;
+}
+
+static bool _same_stamp(const save_index_entry &a, const save_index_entry &b)
+{
+    return a.mtime == b.mtime && a.size == b.size;
+}
+
+static void _marshall_save_index_entry(writer &outf, const string &filename,
+                                       const save_index_entry &entry)
+{
+    const player_save_info &p = entry.info;
+    marshallString(outf, filename);
+    marshallSigned(outf, entry.mtime);
+    marshallSigned(outf, entry.size);
+    marshallString(outf, p.name);
+    marshallInt(outf, p.experience);
+    marshallInt(outf, p.experience_level);
+    marshallBoolean(outf, p.wizard);
+    marshallShort(outf, p.species);
+    marshallString(outf, p.species_name);
+    marshallString(outf, p.class_name);
+    marshallShort(outf, p.religion);
+    marshallString(outf, p.god_name);
+    marshallString(outf, p.jiyva_second_name);
+    marshallByte(outf, p.saved_game_type);
+    marshallBoolean(outf, p.save_loadable);
+    marshallBoolean(outf, entry.has_doll);
+    marshallString(outf, entry.doll);
+}
+
+static string _unmarshall_save_index_entry(reader &inf,
+                                           save_index_entry &entry)
+{
+    player_save_info &p = entry.info;
+    const string filename = unmarshallString(inf);
+    entry.mtime          = unmarshallSigned(inf);
+    entry.size           = unmarshallSigned(inf);
+    p.name               = unmarshallString(inf);
+    p.experience         = unmarshallInt(inf);
+    p.experience_level   = unmarshallInt(inf);
+    p.wizard             = unmarshallBoolean(inf);
+    p.species            = static_cast<species_type>(unmarshallShort(inf));
+    p.species_name       = unmarshallString(inf);
+    p.class_name         = unmarshallString(inf);
+    p.religion           = static_cast<god_type>(unmarshallShort(inf));
+    p.god_name           = unmarshallString(inf);
+    p.jiyva_second_name  = unmarshallString(inf);
+    p.saved_game_type    = static_cast<game_type>(unmarshallByte(inf));
+    p.save_loadable      = unmarshallBoolean(inf);
+    entry.has_doll       = unmarshallBoolean(inf);
+    entry.doll           = unmarshallString(inf);
+    p.filename           = filename;
+    return filename;
+}
+
+// Reads the index into idx; a missing, damaged or outdated index just
+// leaves it empty, and everything gets rescanned.
+static void _read_save_index(const string &path, save_index &idx)
+{
+    idx.clear();
+
+    FILE *fp = fopen_u(path.c_str(), "rb");
+    if (!fp)
+        return;
+
+    try
+    {
+        reader inf(fp);
+        if (unmarshallString(inf) == Version::Long
+            && unmarshallUByte(inf) == SAVE_INDEX_FORMAT)
+        {
+            for (int n = unmarshallInt(inf); n > 0; --n)
+            {
+                save_index_entry entry;
+                const string filename =
+                    _unmarshall_save_index_entry(inf, entry);
+                idx[filename] = entry;
+            }
+        }
+    }
+    catch (short_read_exception &E)
+    {
+        idx.clear();
+    }
+    catch (ext_fail_exception &E)
+    {
+        idx.clear();
+    }
+
+    fclose(fp);
+}
+
+// Writers hold this lock from reading the index until they have renamed
+// the new one into place, so that two games saving at once can't each
+// write back a copy that lacks the other's entry.  Readers never lock.
+static FILE *_lock_save_index(const string &path)
+{
+    return lk_open("a", path + ".lock");
+}
+
+static void _unlock_save_index(FILE *lock, const string &path)
+{
+    lk_close(lock, "a", path + ".lock");
+}
+
+// Replaces the index on disk; the caller must hold the index lock.
+static void _write_save_index(const string &path, const save_index &idx)
+{
+    const string tmpname = path + ".tmp";
+    if (FILE *fp = fopen_replace(tmpname.c_str()))
+    {
+        writer outf(tmpname, fp, true);
+        marshallString(outf, Version::Long);
+        marshallUByte(outf, SAVE_INDEX_FORMAT);
+        marshallInt(outf, idx.size());
+        for (save_index::const_iterator i = idx.begin(); i != idx.end(); ++i)
+            _marshall_save_index_entry(outf, i->first, i->second);
+        const bool ok = outf.succeeded();
+        fclose(fp);
+
+        if (!ok || rename_u(tmpname.c_str(), path.c_str()))
+            unlink_u(tmpname.c_str());
+    }
+}
+
+// Records the current character in the index of its save directory.  Must
+// be called after the package has been written out, so that the stamp
+// matches what is on disk.
+static void _update_save_index()
+{
+    if (Options.no_save)
+        return;
+
+    const string filename = get_save_filename(you.your_name);
+    save_index_entry entry;
+    if (!_save_stamp(_get_savedir_path(filename), entry))
+        return;
+
+    entry.info = you;
+    entry.info.save_loadable = true;
+    entry.info.filename = filename;
+#ifdef USE_TILE
+    vector<unsigned char> doll;
+    writer dollw(&doll);
+    save_doll_file(dollw);
+    entry.doll.assign(doll.begin(), doll.end());
+    entry.has_doll = true;
+#endif
+
+    const string index_file = _get_savedir_path(SAVE_INDEX_FILE);
+    FILE *lock = _lock_save_index(index_file);
+    if (!lock)
+        return;
+
+    save_index idx;
+    _read_save_index(index_file, idx);
+    idx[filename] = entry;
+    _write_save_index(index_file, idx);
+    _unlock_save_index(lock, index_file);
+}
+
+// Writes back an index rebuilt by an unlocked scan of the save directory,
+// starting from old_idx.  Other games may have saved during the scan, so
+// entries they changed win over ours, and saves that appeared after the
+// directory was listed are kept.
+static void _merge_save_index(const string &path, const save_index &old_idx,
+                              save_index &idx)
+{
+    FILE *lock = _lock_save_index(path);
+    if (!lock)
+        return;
+
+    save_index cur;
+    _read_save_index(path, cur);
+    for (save_index::const_iterator i = cur.begin(); i != cur.end(); ++i)
+    {
+        save_index::const_iterator old = old_idx.find(i->first);
+        save_index_entry ondisk;
+        if (old != old_idx.end() && _same_stamp(old->second, i->second))
+            continue;
+        if (idx.count(i->first)
+            || _save_stamp(_get_savedir_path(i->first), ondisk))
+        {
+            idx[i->first] = i->second;
+        }
+    }
+
+    _write_save_index(path, idx);
+    _unlock_save_index(lock, path);
+}
+
 /*
  * Returns a list of the names of characters that are already saved for the
  * current user.
@@ -638,38 +875,75 @@ static vector<player_save_info> _find_saved_characters()
     if (searchpath.empty())
         searchpath = ".";
 
+    const string index_file = _get_savedir_path(SAVE_INDEX_FILE);
+    save_index old_idx, idx;
+    _read_save_index(index_file, old_idx);
+    bool stale = false;
+
+#ifdef USE_TILE
+    const bool want_doll = Options.tile_menu_icons;
+#else
+    const bool want_doll = false;
+#endif
+
     vector<string> allfiles = get_dir_files(searchpath);
     for (unsigned int i = 0; i < allfiles.size(); ++i)
     {
         string filename = allfiles[i];
 
-        string::size_type point_pos = filename.find_first_of('.');
-        string basename = filename.substr(0, point_pos);
+        if (!is_save_file_name(filename))
+            continue;
+
+        save_index_entry entry;
+        if (!_save_stamp(_get_savedir_path(filename), entry))
+            continue;
 
-        if (is_save_file_name(filename))
+        save_index::const_iterator old = old_idx.find(filename);
+        if (old != old_idx.end() && _same_stamp(old->second, entry)
+            && (old->second.has_doll || !want_doll))
         {
+            entry = old->second;
+        }
+        else
+        {
+            stale = true;
             try
             {
                 package save(_get_savedir_path(filename).c_str(), false);
-                player_save_info p = _read_character_info(&save);
-                if (!p.name.empty())
-                {
-                    p.filename = filename;
+                entry.info = _read_character_info(&save);
 #ifdef USE_TILE
-                    if (Options.tile_menu_icons && save.has_chunk("tdl"))
-                        _fill_player_doll(p, &save);
-#endif
-                    chars.push_back(p);
+                if (want_doll)
+                {
+                    entry.doll = _read_doll_line(&save);
+                    entry.has_doll = true;
                 }
+#endif
             }
             catch (ext_fail_exception &E)
             {
                 dprf("%s: %s", filename.c_str(), E.msg.c_str());
+                // Remember broken saves too, so they're not reopened
+                // every time.
+                entry.info.name.clear();
             }
+            entry.info.filename = filename;
         }
+        idx[filename] = entry;
 
+        if (!entry.info.name.empty())
+        {
+            player_save_info p = entry.info;
+#ifdef USE_TILE
+            if (want_doll)
+                _fill_player_doll(p, entry.doll);
+#endif
+            chars.push_back(p);
+        }
     }
 
+    if (stale || idx.size() != old_idx.size())
+        _merge_save_index(index_file, old_idx, idx);
+
     sort(chars.rbegin(), chars.rend());
 #endif // !DISABLE_SAVEGAME_LISTS
     return chars;
@@ -994,8 +1268,7 @@ static void _clear_env_map()
 
 static void _clear_clouds()
 {
-    for (int clouty = 0; clouty < MAX_CLOUDS; ++clouty)
-        delete_cloud(clouty);
+    delete_all_clouds();
     env.cgrid.init(EMPTY_CLOUD);
 }
 
@@ -1347,7 +1620,7 @@ bool load_level(dungeon_feature_type stair_taken, load_mode_type load_mode,
     else
     {
         dprf("Loading old level '%s'.", level_name.c_str());
-        _restore_tagged_chunk(you.save, level_name, TAG_LEVEL, "Level file is invalid.");
+        _restore_level(level_name);
 
         // POST-LOAD tasks :
 #if TAG_MAJOR_VERSION == 34
@@ -1581,6 +1854,28 @@ bool load_level(dungeon_feature_type stair_taken, load_mode_type load_mode,
     return just_created_level;
 }
 
+// A level is stored as several chunks, so they can be decompressed in
+// parallel when loading.  The grid chunk keeps the bare level name.
+static const tag_type _level_tags[] =
+{
+    TAG_LEVEL, TAG_LEVEL_ITEMS, TAG_LEVEL_MONSTERS, TAG_LEVEL_TILES,
+};
+
+static string _level_chunk_name(const string &level_name, tag_type tag)
+{
+    switch (tag)
+    {
+    case TAG_LEVEL_ITEMS:
+        return level_name + ".items";
+    case TAG_LEVEL_MONSTERS:
+        return level_name + ".monsters";
+    case TAG_LEVEL_TILES:
+        return level_name + ".tiles";
+    default:
+        return level_name;
+    }
+}
+
 static void _save_level(const level_id& lid)
 {
     travel_cache.get_level_info(lid).update();
@@ -1588,7 +1883,38 @@ static void _save_level(const level_id& lid)
     // Nail all items to the ground.
     fix_item_coordinates();
 
-    _write_tagged_chunk(lid.describe(), TAG_LEVEL);
+    const string level_name = lid.describe();
+    for (unsigned int i = 0; i < ARRAYSZ(_level_tags); i++)
+    {
+        _write_tagged_chunk(_level_chunk_name(level_name, _level_tags[i]),
+                            _level_tags[i]);
+    }
+}
+
+static void _restore_level(const string &level_name)
+{
+    vector<string> names;
+    for (unsigned int i = 0; i < ARRAYSZ(_level_tags); i++)
+        names.push_back(_level_chunk_name(level_name, _level_tags[i]));
+
+#if TAG_MAJOR_VERSION == 34
+    if (!you.save->has_chunk(names[1]))
+    {
+        _restore_tagged_chunk(you.save, level_name, TAG_LEVEL,
+                              "Level file is invalid.");
+        return;
+    }
+#endif
+
+    // Inflate everything up front, then unmarshall in the usual order.
+    vector<vector<unsigned char> > data;
+    you.save->read_chunks(names, data);
+    for (unsigned int i = 0; i < names.size(); i++)
+    {
+        reader inf(data[i]);
+        _restore_tagged_reader(inf, names[i], _level_tags[i],
+                               "Level file is invalid.");
+    }
 }
 
 #if TAG_MAJOR_VERSION == 34
@@ -1687,13 +2013,17 @@ void save_game(bool leave_game, const char *farewellmsg)
     if (!leave_game)
     {
         if (!crawl_state.disables[DIS_SAVE_CHECKPOINTS])
+        {
             you.save->commit();
+            _update_save_index();
+        }
         return;
     }
 
     // Stack allocated string's go in separate function,
     // so Valgrind doesn't complain.
     _save_game_exit();
+    _update_save_index();
 
     end(0, false, farewellmsg? "%s" : "See you soon, %s!",
         farewellmsg? farewellmsg : you.your_name.c_str());
@@ -1988,7 +2318,13 @@ void delete_level(const level_id &level)
     clear_level_annotations(level);
 
     if (you.save)
-        you.save->delete_chunk(level.describe());
+    {
+        for (unsigned int i = 0; i < ARRAYSZ(_level_tags); i++)
+        {
+            you.save->delete_chunk(_level_chunk_name(level.describe(),
+                                                     _level_tags[i]));
+        }
+    }
     if (level.branch == BRANCH_ABYSS)
     {
         save_abyss_uniques();
@@ -2160,6 +2496,12 @@ static bool _restore_tagged_chunk(package *save, const string name,
                                   tag_type tag, const char* complaint)
 {
     reader inf(save, name);
+    return _restore_tagged_reader(inf, name, tag, complaint);
+}
+
+static bool _restore_tagged_reader(reader &inf, const string name,
+                                   tag_type tag, const char* complaint)
+{
     string reason;
     if (!_tagged_chunk_version_compatible(inf, &reason))
     {
@@ -2378,3 +2720,323 @@ vector<string> get_title_files()
     }
     return titles;
 }
+
+//////////////////////////////////////////////////////////////////////////
+// Save benchmark (-savebench)
+//
+// Loads a save read-only, then repeatedly serializes and deserializes
+// each kind of chunk, both in memory and through a scratch package (so
+// with the deflate, inflate and file I/O that save_game() and
+// load_level() go through), reporting timings and sizes as JSON on
+// stdout.  Every chunk must come back byte-identical after a round trip.
+
+#define SAVEBENCH_ITERATIONS 10
+
+typedef vector<unsigned char> bench_buf;
+
+static package *_bench_package;
+
+static void _bench_save_you(writer &outf)    { tag_write(TAG_YOU, outf); }
+static void _bench_save_stash(writer &outf)  { StashTrack.save(outf); }
+static void _bench_save_kills(writer &outf)  { you.kills->save(outf); }
+static void _bench_save_travel(writer &outf) { travel_cache.save(outf); }
+static void _bench_save_notes(writer &outf)  { save_notes(outf); }
+static void _bench_save_msgs(writer &outf)   { save_messages(outf); }
+static void _bench_save_level(writer &outf)  { tag_write(TAG_LEVEL, outf); }
+static void _bench_save_items(writer &outf)  { tag_write(TAG_LEVEL_ITEMS, outf); }
+static void _bench_save_mons(writer &outf)   { tag_write(TAG_LEVEL_MONSTERS, outf); }
+static void _bench_save_tiles(writer &outf)  { tag_write(TAG_LEVEL_TILES, outf); }
+
+static void _bench_load_you(const bench_buf &buf)
+{
+    // tag_read() expects a fresh player, and appends to these.
+    you.exercises.clear();
+    you.exercises_all.clear();
+    you.beholders.clear();
+    you.fearmongers.clear();
+
+    reader inf(buf, TAG_MINOR_VERSION);
+    tag_read(inf, TAG_YOU);
+}
+
+static void _bench_load_stash(const bench_buf &buf)
+{
+    reader inf(buf, TAG_MINOR_VERSION);
+    StashTrack.load(inf);
+}
+
+static void _bench_load_kills(const bench_buf &buf)
+{
+    reader inf(buf, TAG_MINOR_VERSION);
+    you.kills->load(inf);
+}
+
+static void _bench_load_travel(const bench_buf &buf)
+{
+    reader inf(buf, TAG_MINOR_VERSION);
+    travel_cache.load(inf, TAG_MINOR_VERSION);
+}
+
+static void _bench_load_notes(const bench_buf &buf)
+{
+    reader inf(buf, TAG_MINOR_VERSION);
+    note_list.clear();
+    load_notes(inf);
+}
+
+static void _bench_load_msgs(const bench_buf &buf)
+{
+    reader inf(buf, TAG_MINOR_VERSION);
+    clear_message_store();
+    load_messages(inf);
+}
+
+static void _bench_load_level(const bench_buf &buf)
+{
+    reader inf(buf, TAG_MINOR_VERSION);
+    tag_read(inf, TAG_LEVEL);
+}
+
+static void _bench_load_items(const bench_buf &buf)
+{
+    reader inf(buf, TAG_MINOR_VERSION);
+    tag_read(inf, TAG_LEVEL_ITEMS);
+}
+
+static void _bench_load_mons(const bench_buf &buf)
+{
+    reader inf(buf, TAG_MINOR_VERSION);
+    tag_read(inf, TAG_LEVEL_MONSTERS);
+}
+
+static void _bench_load_tiles(const bench_buf &buf)
+{
+    reader inf(buf, TAG_MINOR_VERSION);
+    tag_read(inf, TAG_LEVEL_TILES);
+}
+
+#ifdef CLUA_BINDINGS
+static void _bench_save_lua(writer &outf) { clua.save(outf); }
+
+static void _bench_load_lua(const bench_buf &buf)
+{
+    string code(buf.begin(), buf.end());
+    clua.execstring(code.c_str());
+}
+#endif
+
+static bool _bench_chunk(const string &name, const string &chunk,
+                         void (*save)(writer &),
+                         void (*load)(const bench_buf &), bool &first)
+{
+    bench_buf orig;
+    {
+        writer outf(&orig);
+        save(outf);
+    }
+
+    uint64_t start = get_time_usec();
+    for (int i = 0; i < SAVEBENCH_ITERATIONS; ++i)
+    {
+        bench_buf buf;
+        writer outf(&buf);
+        save(outf);
+    }
+    const double write_usec = double(get_time_usec() - start)
+                              / SAVEBENCH_ITERATIONS;
+
+    start = get_time_usec();
+    for (int i = 0; i < SAVEBENCH_ITERATIONS; ++i)
+        load(orig);
+    const double read_usec = double(get_time_usec() - start)
+                             / SAVEBENCH_ITERATIONS;
+
+    start = get_time_usec();
+    for (int i = 0; i < SAVEBENCH_ITERATIONS; ++i)
+    {
+        {
+            writer outf(_bench_package, name);
+            save(outf);
+        }
+        _bench_package->commit();
+    }
+    const double package_write_usec = double(get_time_usec() - start)
+                                      / SAVEBENCH_ITERATIONS;
+
+    const vector<string> names(1, name);
+    start = get_time_usec();
+    for (int i = 0; i < SAVEBENCH_ITERATIONS; ++i)
+    {
+        vector<bench_buf> data;
+        _bench_package->read_chunks(names, data);
+        load(data[0]);
+    }
+    const double package_read_usec = double(get_time_usec() - start)
+                                     / SAVEBENCH_ITERATIONS;
+
+    bench_buf again;
+    {
+        writer outf(&again);
+        save(outf);
+    }
+    const bool identical = (again == orig);
+
+    // As stored in the save: deflated, not counting block headers.
+    const plen_t zlen = you.save->has_chunk(chunk)
+                        ? you.save->get_chunk_compressed_length(chunk) : 0;
+
+    printf("%s\n    {\"chunk\": \"%s\", \"raw\": %u, \"compressed\": %u, "
+           "\"write_usec\": %.1f, \"read_usec\": %.1f, "
+           "\"package_write_usec\": %.1f, \"package_read_usec\": %.1f, "
+           "\"identical\": %s}",
+           first ? "" : ",", name.c_str(), (unsigned int)orig.size(),
+           (unsigned int)zlen, write_usec, read_usec, package_write_usec,
+           package_read_usec, identical ? "true" : "false");
+    first = false;
+
+    return identical;
+}
+
+void savebench(const string &filename)
+{
+    string path = filename;
+    if (!file_exists(path))
+        path = get_savedir_filename(filename);
+
+    bool ok = true;
+    try
+    {
+        you.save = new package(path.c_str(), false);
+        if (!_read_char_chunk(you.save))
+            fail("Save is from an incompatible version (%s).",
+                 you.prev_save_version.c_str());
+        _restore_tagged_chunk(you.save, "you", TAG_YOU, "Save data is invalid.");
+
+        const int minorVersion = crawl_state.minorVersion;
+        if (you.save->has_chunk(CHUNK("st", "stashes")))
+        {
+            reader inf(you.save, CHUNK("st", "stashes"), minorVersion);
+            StashTrack.load(inf);
+        }
+        if (you.save->has_chunk(CHUNK("kil", "kills")))
+        {
+            reader inf(you.save, CHUNK("kil", "kills"), minorVersion);
+            you.kills->load(inf);
+        }
+        if (you.save->has_chunk(CHUNK("tc", "travel_cache")))
+        {
+            reader inf(you.save, CHUNK("tc", "travel_cache"), minorVersion);
+            travel_cache.load(inf, minorVersion);
+        }
+        if (you.save->has_chunk(CHUNK("nts", "notes")))
+        {
+            reader inf(you.save, CHUNK("nts", "notes"), minorVersion);
+            load_notes(inf);
+        }
+        if (you.save->has_chunk(CHUNK("msg", "messages")))
+        {
+            reader inf(you.save, CHUNK("msg", "messages"), minorVersion);
+            load_messages(inf);
+        }
+#ifdef CLUA_BINDINGS
+        if (you.save->has_chunk("lua"))
+        {
+            vector<char> buf;
+            chunk_reader inf(you.save, "lua");
+            inf.read_all(buf);
+            buf.push_back(0);
+            clua.execstring(&buf[0]);
+        }
+#endif
+
+        _bench_package = new package();
+
+        printf("{\n  \"save\": \"%s\",\n  \"iterations\": %d,\n"
+               "  \"chunks\": [", path.c_str(), SAVEBENCH_ITERATIONS);
+        bool first = true;
+
+        ok &= _bench_chunk("you", "you", _bench_save_you, _bench_load_you,
+                           first);
+        ok &= _bench_chunk("stashes", CHUNK("st", "stashes"),
+                           _bench_save_stash, _bench_load_stash, first);
+        ok &= _bench_chunk("kills", CHUNK("kil", "kills"),
+                           _bench_save_kills, _bench_load_kills, first);
+        ok &= _bench_chunk("travel_cache", CHUNK("tc", "travel_cache"),
+                           _bench_save_travel, _bench_load_travel, first);
+        ok &= _bench_chunk("notes", CHUNK("nts", "notes"),
+                           _bench_save_notes, _bench_load_notes, first);
+        ok &= _bench_chunk("messages", CHUNK("msg", "messages"),
+                           _bench_save_msgs, _bench_load_msgs, first);
+#ifdef CLUA_BINDINGS
+        ok &= _bench_chunk("lua", "lua", _bench_save_lua, _bench_load_lua,
+                           first);
+#endif
+
+        const branch_type old_branch = you.where_are_you;
+        const int old_depth = you.depth;
+        vector<string> chunks = you.save->list_chunks();
+        sort(chunks.begin(), chunks.end(), numcmpstr);
+        for (unsigned int i = 0; i < chunks.size(); ++i)
+        {
+            level_id lid;
+            try
+            {
+                lid = level_id::parse_level_id(chunks[i]);
+            }
+            catch (const string &err)
+            {
+                continue;
+            }
+            // Skips level sub-chunks ("D:3.items") as well.
+            if (lid.describe() != chunks[i])
+                continue;
+
+            you.where_are_you = lid.branch;
+            you.depth = lid.depth;
+            _restore_level(chunks[i]);
+
+            for (unsigned int j = 0; j < ARRAYSZ(_level_tags); ++j)
+            {
+                const string name = _level_chunk_name(chunks[i],
+                                                      _level_tags[j]);
+                switch (_level_tags[j])
+                {
+                case TAG_LEVEL:
+                    ok &= _bench_chunk(name, name, _bench_save_level,
+                                       _bench_load_level, first);
+                    break;
+                case TAG_LEVEL_ITEMS:
+                    ok &= _bench_chunk(name, name, _bench_save_items,
+                                       _bench_load_items, first);
+                    break;
+                case TAG_LEVEL_MONSTERS:
+                    ok &= _bench_chunk(name, name, _bench_save_mons,
+                                       _bench_load_mons, first);
+                    break;
+                case TAG_LEVEL_TILES:
+                    ok &= _bench_chunk(name, name, _bench_save_tiles,
+                                       _bench_load_tiles, first);
+                    break;
+                default:
+                    die("unknown level tag");
+                }
+            }
+        }
+        you.where_are_you = old_branch;
+        you.depth = old_depth;
+
+        printf("\n  ],\n  \"identical\": %s\n}\n", ok ? "true" : "false");
+    }
+    catch (ext_fail_exception &fe)
+    {
+        fprintf(stderr, "Error: %s\n", fe.msg.c_str());
+        ok = false;
+    }
+
+    delete _bench_package;
+    _bench_package = 0;
+    delete you.save;
+    you.save = 0;
+
+    end(ok ? 0 : 1, false);
+}
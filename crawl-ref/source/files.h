@@ -82,6 +82,8 @@ bool restore_game(const string& filename);
 
 bool is_existing_level(const level_id &level);
 
+void savebench(const string &filename);
+
 class level_excursion
 {
 protected:
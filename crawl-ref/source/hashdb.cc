@@ -0,0 +1,335 @@
+/**
+ * @file
+ * @brief Read-only key to text store indexed by a minimal perfect hash.
+**/
+
+/*
+File layout, all words are 32-bit little-endian:
+
+  magic, format version, number of entries (n), number of buckets (nb)
+  nb displacements
+  n slots, each the index of the entry that hashes there
+  n entries of (key offset, key length, value offset, value length)
+  key and value text
+
+The hash is "hash and displace": a key's bucket is picked with seed 0.  A
+positive displacement d for that bucket means the key's slot is picked with
+seed d; a negative one names the slot directly (-d - 1), which is used for
+buckets holding a single key.  Every key maps to a distinct slot, so a
+lookup is two hashes and one comparison against the stored key.
+*/
+
+#include "AppHdr.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#ifndef TARGET_COMPILER_VC
+#include <unistd.h>
+#endif
+#ifndef TARGET_OS_WINDOWS
+#include <sys/mman.h>
+#define USE_MMAP
+#endif
+
+#include "hashdb.h"
+#include "endianness.h"
+#include "syscalls.h"
+
+#define HASHDB_MAGIC   0x42445348 // "HSDB"
+#define HASHDB_VERSION 1
+#define HEADER_WORDS   4
+#define ENTRY_WORDS    4
+
+// Give up on a bucket after this many displacements; doesn't happen in
+// practice with one bucket per key.
+#define MAX_DISPLACEMENT (1 << 24)
+
+static uint32_t _hash(uint32_t seed, const char *s, size_t len)
+{
+    // FNV-1a, followed by a finaliser so the low bits are usable for %.
+    uint32_t h = 2166136261U ^ seed;
+    for (size_t i = 0; i < len; ++i)
+    {
+        h ^= (unsigned char)s[i];
+        h *= 16777619U;
+    }
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+static uint32_t _hash(uint32_t seed, const string &s)
+{
+    return _hash(seed, s.data(), s.length());
+}
+
+// ----------------------------------------------------------------------
+// hash_db_writer
+// ----------------------------------------------------------------------
+
+void hash_db_writer::add(const string &key, const string &value)
+{
+    map<string, uint32_t>::const_iterator i = index.find(key);
+    if (i != index.end())
+    {
+        entries[i->second].second = value;
+        return;
+    }
+
+    index[key] = entries.size();
+    entries.push_back(make_pair(key, value));
+}
+
+static bool _bucket_larger(const vector<uint32_t> &a,
+                           const vector<uint32_t> &b)
+{
+    return a.size() > b.size();
+}
+
+bool hash_db_writer::write(const string &filename) const
+{
+    const uint32_t n = entries.size();
+    const uint32_t nb = max(n, 1U);
+
+    // Group the entries by bucket; each bucket remembers its own number
+    // in its last element so that sorting doesn't lose it.
+    vector<vector<uint32_t> > buckets(nb);
+    for (uint32_t i = 0; i < n; ++i)
+        buckets[_hash(0, entries[i].first) % nb].push_back(i);
+    for (uint32_t b = 0; b < nb; ++b)
+        buckets[b].push_back(b);
+    sort(buckets.begin(), buckets.end(), _bucket_larger);
+
+    vector<int32_t> disp(nb, 0);
+    vector<uint32_t> slots(n, 0);
+    vector<bool> used(n, false);
+
+    // Place the crowded buckets first, while there's still room.
+    uint32_t b = 0;
+    for (; b < nb && buckets[b].size() > 2; ++b)
+    {
+        const vector<uint32_t> &bucket = buckets[b];
+        const size_t keys = bucket.size() - 1;
+        vector<uint32_t> tried;
+        int32_t d = 1;
+        for (; d < MAX_DISPLACEMENT; ++d)
+        {
+            tried.clear();
+            size_t k = 0;
+            for (; k < keys; ++k)
+            {
+                const uint32_t s = _hash(d, entries[bucket[k]].first) % n;
+                if (used[s] || find(tried.begin(), tried.end(), s)
+                               != tried.end())
+                {
+                    break;
+                }
+                tried.push_back(s);
+            }
+            if (k == keys)
+                break;
+        }
+        if (d == MAX_DISPLACEMENT)
+            return false;
+
+        for (size_t k = 0; k < keys; ++k)
+        {
+            used[tried[k]] = true;
+            slots[tried[k]] = bucket[k];
+        }
+        disp[bucket.back()] = d;
+    }
+
+    // Single keys go straight into whatever slots are left.
+    uint32_t free_slot = 0;
+    for (; b < nb && buckets[b].size() == 2; ++b)
+    {
+        while (used[free_slot])
+            ++free_slot;
+        used[free_slot] = true;
+        slots[free_slot] = buckets[b][0];
+        disp[buckets[b].back()] = -(int32_t)free_slot - 1;
+    }
+
+    vector<uint32_t> words;
+    words.push_back(HASHDB_MAGIC);
+    words.push_back(HASHDB_VERSION);
+    words.push_back(n);
+    words.push_back(nb);
+    for (uint32_t i = 0; i < nb; ++i)
+        words.push_back(disp[i]);
+    for (uint32_t i = 0; i < n; ++i)
+        words.push_back(slots[i]);
+
+    uint32_t off = (words.size() + n * ENTRY_WORDS) * sizeof(uint32_t);
+    string text;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        const string &k = entries[i].first, &v = entries[i].second;
+        words.push_back(off + text.length());
+        words.push_back(k.length());
+        text += k;
+        words.push_back(off + text.length());
+        words.push_back(v.length());
+        text += v;
+    }
+
+    for (size_t i = 0; i < words.size(); ++i)
+        words[i] = htole32(words[i]);
+
+    FILE *f = fopen_u(filename.c_str(), "wb");
+    if (!f)
+        return false;
+    bool ok = fwrite(&words[0], sizeof(uint32_t), words.size(), f)
+              == words.size();
+    if (!text.empty())
+        ok = ok && fwrite(text.data(), 1, text.length(), f) == text.length();
+    return !fclose(f) && ok;
+}
+
+// ----------------------------------------------------------------------
+// hash_db
+// ----------------------------------------------------------------------
+
+hash_db::hash_db()
+    : data(0), data_len(0), mapped(false), n_entries(0), n_buckets(0)
+{
+}
+
+hash_db::~hash_db()
+{
+    close();
+}
+
+bool hash_db::open(const string &filename)
+{
+    close();
+
+    int fd = open_u(filename.c_str(), O_RDONLY | O_BINARY, 0);
+    if (fd == -1)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) || st.st_size < HEADER_WORDS * (off_t)sizeof(uint32_t)
+        || st.st_size > 0x7fffffff)
+    {
+        ::close(fd);
+        return false;
+    }
+    data_len = st.st_size;
+
+#ifdef USE_MMAP
+    void *m = mmap(0, data_len, PROT_READ, MAP_SHARED, fd, 0);
+    if (m != MAP_FAILED)
+    {
+        data = (char*)m;
+        mapped = true;
+    }
+    else
+#endif
+    {
+        data = (char*)malloc(data_len);
+        if (!data || read(fd, data, data_len) != (ssize_t)data_len)
+        {
+            ::close(fd);
+            close();
+            return false;
+        }
+    }
+    ::close(fd);
+
+    n_entries = word(2);
+    n_buckets = word(3);
+    const uint64_t table_words = (uint64_t)HEADER_WORDS + n_buckets
+                                 + (uint64_t)n_entries * (1 + ENTRY_WORDS);
+    if (word(0) != HASHDB_MAGIC || word(1) != HASHDB_VERSION
+        || !n_buckets || table_words * sizeof(uint32_t) > data_len)
+    {
+        close();
+        return false;
+    }
+
+    // Check everything up front, so that lookups can trust the file.
+    for (uint32_t i = 0; i < n_entries; ++i)
+    {
+        const uint32_t *e = entry(i);
+        if (word(HEADER_WORDS + n_buckets + i) >= n_entries
+            || (uint64_t)htole32(e[0]) + htole32(e[1]) > data_len
+            || (uint64_t)htole32(e[2]) + htole32(e[3]) > data_len)
+        {
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void hash_db::close()
+{
+    if (!data)
+        return;
+
+#ifdef USE_MMAP
+    if (mapped)
+        munmap(data, data_len);
+    else
+#endif
+        free(data);
+    data = 0;
+    data_len = 0;
+    mapped = false;
+    n_entries = n_buckets = 0;
+}
+
+uint32_t hash_db::word(uint32_t off) const
+{
+    return htole32(((const uint32_t*)data)[off]);
+}
+
+const uint32_t *hash_db::entry(uint32_t i) const
+{
+    return (const uint32_t*)data + HEADER_WORDS + n_buckets + n_entries
+           + i * ENTRY_WORDS;
+}
+
+bool hash_db::fetch(const string &key, const char *&val, uint32_t &len) const
+{
+    if (!n_entries)
+        return false;
+
+    const int32_t d = word(HEADER_WORDS + _hash(0, key) % n_buckets);
+    const uint32_t slot = d < 0 ? -(d + 1) : _hash(d, key) % n_entries;
+    if (slot >= n_entries)
+        return false;
+
+    const uint32_t *e = entry(word(HEADER_WORDS + n_buckets + slot));
+    if (htole32(e[1]) != key.length()
+        || memcmp(data + htole32(e[0]), key.data(), key.length()))
+    {
+        return false;
+    }
+
+    val = data + htole32(e[2]);
+    len = htole32(e[3]);
+    return true;
+}
+
+string hash_db::key(uint32_t i) const
+{
+    const uint32_t *e = entry(i);
+    return string(data + htole32(e[0]), htole32(e[1]));
+}
+
+string hash_db::value(uint32_t i) const
+{
+    const uint32_t *e = entry(i);
+    return string(data + htole32(e[2]), htole32(e[3]));
+}
@@ -0,0 +1,60 @@
+/**
+ * @file
+ * @brief Read-only key to text store indexed by a minimal perfect hash.
+**/
+
+#ifndef HASHDB_H
+#define HASHDB_H
+
+#include <string>
+#include <map>
+#include <vector>
+
+// Collects entries in memory and writes them out as a hash_db file.
+// Adding a key that is already present replaces its value, but keeps its
+// original position in iteration order.
+class hash_db_writer
+{
+public:
+    void add(const string &key, const string &value);
+    bool write(const string &filename) const;
+
+private:
+    vector<pair<string, string> > entries;
+    map<string, uint32_t> index;
+};
+
+// A database written by hash_db_writer.  Lookups cost two hashes and one
+// key comparison, and hand out pointers into the (usually mmap()ed) file,
+// so values are only copied if the caller wants a string.
+//
+// Entries can also be walked in insertion order, for regex searches over
+// the whole database.
+class hash_db
+{
+public:
+    hash_db();
+    ~hash_db();
+
+    bool open(const string &filename);
+    void close();
+    bool is_open() const { return data; }
+
+    bool fetch(const string &key, const char *&val, uint32_t &len) const;
+
+    uint32_t size() const { return n_entries; }
+    string key(uint32_t i) const;
+    string value(uint32_t i) const;
+
+private:
+    const uint32_t *entry(uint32_t i) const;
+    uint32_t word(uint32_t off) const;
+
+    char *data;
+    uint32_t data_len;
+    bool mapped;
+    uint32_t n_entries;
+    uint32_t n_buckets;
+};
+
+#endif
@@ -682,6 +682,8 @@ static string _resolve_dir(const char* path, const char* suffix)
 
 void game_options::reset_options()
 {
+    ++generation;
+
     filename     = "unknown";
     basefilename = "unknown";
     line_num     = -1;
@@ -958,6 +960,9 @@ void game_options::reset_options()
 
     no_dark_brand      = true;
 
+    lua_profile        = false;
+    lua_hook_budget    = 0;
+
 #ifdef WIZARD
 #ifdef DGAMELAUNCH
     if (wiz_mode != WIZ_NO)
@@ -1597,6 +1602,7 @@ game_options::game_options()
 {
     lang = LANG_EN; // FIXME: obtain from gettext
     lang_name = 0;
+    generation = 0;
     reset_options();
 }
 
@@ -2194,6 +2200,8 @@ void game_options::read_option_line(const string &str, bool runscript)
         _handle_list(_opt_var, field, plus_equal, caret_equal, minus_equal); \
     } while (false)
 #define LIST_OPTION(_opt) LIST_OPTION_NAMED(#_opt, _opt)
+    ++generation;
+
     string key    = "";
     string subkey = "";
     string field  = "";
@@ -2504,6 +2512,8 @@ void game_options::read_option_line(const string &str, bool runscript)
         terp_files.push_back(field);
 #endif
     }
+    else BOOL_OPTION(lua_profile);
+    else INT_OPTION(lua_hook_budget, 0, 60000);
     else if (key == "colour" || key == "color")
     {
         const int orig_col   = str_to_colour(subkey);
@@ -3799,6 +3809,7 @@ enum commandline_option_type
     CLO_TEST,
     CLO_SCRIPT,
     CLO_BUILDDB,
+    CLO_SAVEBENCH,
     CLO_HELP,
     CLO_VERSION,
     CLO_SEED,
@@ -3828,7 +3839,7 @@ static const char *cmd_ops[] =
     "scores", "name", "species", "background", "plain", "dir", "rc",
     "rcdir", "tscores", "vscores", "scorefile", "morgue", "macro",
     "mapstat", "arena", "dump-maps", "test", "script", "builddb",
-    "help", "version", "seed", "save-version", "sprint",
+    "savebench", "help", "version", "seed", "save-version", "sprint",
     "extra-opt-first", "extra-opt-last", "sprint-map", "edit-save",
     "print-charset", "zotdef", "tutorial", "wizard", "no-save",
     "gdb", "no-gdb", "nogdb",
@@ -4343,6 +4354,13 @@ bool parse_args(int argc, char **argv, bool rc_only)
             crawl_state.build_db = true;
             break;
 
+        case CLO_SAVEBENCH:
+            if (!next_is_param)
+                return false;
+            crawl_state.savebench = next_arg;
+            nextUsed = true;
+            break;
+
         case CLO_GDB:
             crawl_state.no_gdb = 0;
             break;
@@ -106,8 +106,8 @@ string item_def::name(description_level_type descrip, bool terse, bool ident,
 
     ostringstream buff;
 
-    const string auxname = name_aux(descrip, terse, ident, with_inscription,
-                                    ignore_flags);
+    const string auxname = cached_name_aux(descrip, terse, ident,
+                                           with_inscription, ignore_flags);
 
     const bool startvowel     = is_vowel(auxname[0]);
 
@@ -1251,6 +1251,154 @@ static const char* _torn_net(int plus)
         return " [falling apart]";
 }
 
+// name_aux() only looks at the item itself, at whether its type has been
+// identified, and at the options, so its results can be memoised on those.
+// The cache is keyed by item contents rather than by slot so that copies
+// (stash entries, menu items, item_info) hit it too.
+struct name_aux_key
+{
+    name_aux_key(const item_def &item, description_level_type desc,
+                 bool terse, bool ident, bool with_inscription,
+                 iflags_t ignore_flags);
+
+    bool operator<(const name_aux_key &other) const
+    {
+        return memcmp(this, &other, sizeof(*this)) < 0;
+    }
+
+    // Item state.
+    iflags_t flags;
+    iflags_t ignore_flags;
+    uint32_t props_hash;
+    int special;
+    short plus;
+    short plus2;
+    short quantity;
+    uint8_t base_type;
+    uint8_t sub_type;
+    uint8_t rnd;
+    uint8_t type_id;
+    // Arguments.
+    uint8_t desc;
+    uint8_t options;
+};
+
+static uint32_t _hash_mix(uint32_t h, uint32_t v)
+{
+    return (h ^ v) * 16777619U;
+}
+
+static uint32_t _hash_string(uint32_t h, const string &s)
+{
+    for (unsigned int i = 0; i < s.length(); ++i)
+        h = _hash_mix(h, (unsigned char)s[i]);
+    return _hash_mix(h, s.length());
+}
+
+static uint32_t _hash_store(uint32_t h, const CrawlStoreValue &val);
+
+static uint32_t _hash_props(uint32_t h, const CrawlHashTable &props)
+{
+    for (CrawlHashTable::const_iterator i = props.begin(); i != props.end();
+         ++i)
+    {
+        h = _hash_store(_hash_string(h, i->first), i->second);
+    }
+    return h;
+}
+
+static uint32_t _hash_store(uint32_t h, const CrawlStoreValue &val)
+{
+    const store_val_type type = val.get_type();
+    h = _hash_mix(h, type);
+    switch (type)
+    {
+    case SV_BOOL:   return _hash_mix(h, val.get_bool());
+    case SV_BYTE:   return _hash_mix(h, val.get_byte());
+    case SV_SHORT:  return _hash_mix(h, val.get_short());
+    case SV_INT:    return _hash_mix(h, val.get_int());
+    case SV_INT64:
+    {
+        const int64_t v = val.get_int64();
+        return _hash_mix(_hash_mix(h, v), v >> 32);
+    }
+    case SV_FLOAT:
+    {
+        const float f = val.get_float();
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        return _hash_mix(h, bits);
+    }
+    case SV_STR:    return _hash_string(h, val.get_string());
+    case SV_COORD:
+        return _hash_mix(_hash_mix(h, val.get_coord().x), val.get_coord().y);
+    case SV_LEV_ID: return _hash_mix(h, val.get_level_id().packed_place());
+    case SV_HASH:   return _hash_props(h, val.get_table());
+    case SV_VEC:
+    {
+        const CrawlVector &vec = val.get_vector();
+        for (CrawlVector::const_iterator i = vec.begin(); i != vec.end(); ++i)
+            h = _hash_store(h, *i);
+        return _hash_mix(h, vec.size());
+    }
+    default:
+        // Items, monsters and lua chunks don't show up in item names.
+        return h;
+    }
+}
+
+name_aux_key::name_aux_key(const item_def &item, description_level_type _desc,
+                           bool terse, bool ident, bool with_inscription,
+                           iflags_t _ignore_flags)
+{
+    // Zero the padding too, since keys are compared with memcmp.
+    memset(this, 0, sizeof(*this));
+    flags        = item.flags;
+    ignore_flags = _ignore_flags;
+    props_hash   = item.props.empty() ? 0
+                   : _hash_props(2166136261U, item.props);
+    special      = item.special;
+    plus         = item.plus;
+    plus2        = item.plus2;
+    quantity     = item.quantity;
+    base_type    = item.base_type;
+    sub_type     = item.sub_type;
+    rnd          = item.rnd;
+    type_id      = item_type_has_ids(item.base_type)
+                   ? you.type_ids[item.base_type][item.sub_type]
+                   : ID_UNKNOWN_TYPE;
+    desc         = _desc;
+    options      = terse | ident << 1 | with_inscription << 2;
+}
+
+#define NAME_AUX_CACHE_SIZE 4096
+
+string item_def::cached_name_aux(description_level_type desc, bool terse,
+                                 bool ident, bool with_inscription,
+                                 iflags_t ignore_flags) const
+{
+    static map<name_aux_key, string> cache;
+    static unsigned int cache_options = 0;
+
+    if (cache_options != Options.generation
+        || cache.size() >= NAME_AUX_CACHE_SIZE)
+    {
+        cache.clear();
+        cache_options = Options.generation;
+    }
+
+    const name_aux_key key(*this, desc, terse, ident, with_inscription,
+                           ignore_flags);
+    map<name_aux_key, string>::const_iterator i = cache.find(key);
+    if (i != cache.end())
+        return i->second;
+
+    const string name = name_aux(desc, terse, ident, with_inscription,
+                                 ignore_flags);
+    cache[key] = name;
+    return name;
+}
+
 // Note that "terse" is only currently used for the "in hand" listing on
 // the game screen.
 string item_def::name_aux(description_level_type desc, bool terse, bool ident,
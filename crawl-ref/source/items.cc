@@ -36,6 +36,7 @@
 #include "food.h"
 #include "godpassive.h"
 #include "godprayer.h"
+#include "hash.h"
 #include "hints.h"
 #include "hiscores.h"
 #include "invent.h"
@@ -309,6 +310,7 @@ bool dec_inv_item_quantity(int obj, int amount, bool suppress_burden)
                     canned_msg(MSG_EMPTY_HANDED_NOW);
                 }
                 you.equip[i] = -1;
+                you.invalidate_stat_cache();
             }
         }
 
@@ -384,6 +386,31 @@ void init_item(int item)
     mitm[item].clear();
 }
 
+// Finds the lowest free slot below limit on the free list.  Slots stay
+// listed until they are seen in use, so one that a caller took but never
+// filled is handed out again, just as the old linear scan did.
+static int _first_mitm_slot(int limit)
+{
+    for (int item = env.free_items.first();
+         item != -1 && item < limit;
+         item = env.free_items.first())
+    {
+        if (!mitm[item].defined())
+            return item;
+        env.free_items.set(item, false);
+    }
+
+    return NON_ITEM;
+}
+
+// Puts every unused slot back on the free list, whether or not it got there
+// through item_def::clear().
+void rebuild_free_items()
+{
+    for (int i = 0; i < MAX_ITEMS; ++i)
+        env.free_items.set(i, !mitm[i].defined());
+}
+
 // Returns an unused mitm slot, or NON_ITEM if none available.
 // The reserve is the number of item slots to not check.
 // Items may be culled if a reserve <= 10 is specified.
@@ -394,13 +421,16 @@ int get_mitm_slot(int reserve)
     if (crawl_state.game_is_arena())
         reserve = 0;
 
-    int item = NON_ITEM;
+    int item = _first_mitm_slot(MAX_ITEMS - reserve);
 
-    for (item = 0; item < (MAX_ITEMS - reserve); item++)
-        if (!mitm[item].defined())
-            break;
+    if (item == NON_ITEM)
+    {
+        // Look for slots that were freed behind our back before culling.
+        rebuild_free_items();
+        item = _first_mitm_slot(MAX_ITEMS - reserve);
+    }
 
-    if (item >= MAX_ITEMS - reserve)
+    if (item == NON_ITEM)
     {
         if (crawl_state.game_is_arena())
         {
@@ -2545,11 +2575,135 @@ static int _autopickup_subtype(const item_def &item)
     }
 }
 
-static bool _is_option_autopickup(const item_def &item, string &iname)
+// What the autopickup options say about a whole item class.
+enum autopickup_verdict
 {
-    if (iname.empty())
-        iname = _autopickup_item_name(item);
+    AP_NO,
+    AP_YES,
+    AP_BY_NAME,     // depends on the item's name
+};
+
+// Compiled from the options.  Exceptions can each only override a class's
+// default one way (towards pickup, or away from it), so a class only needs
+// its items' names matched if some rule could override its default.  Lua
+// hooks work the same way, but scripts can change them at any time, so
+// they are checked on every call instead.
+static autopickup_verdict autopickup_table[NUM_OBJECT_CLASSES];
+static bool autopickup_table_valid = false;
+static unsigned autopickup_table_generation;
+
+// Decisions for items that did need their names, for as long as the
+// options and the player don't change.
+struct autopickup_key
+{
+    explicit autopickup_key(const item_def &item)
+    {
+        // Keys are compared with memcmp, so zero the padding too.
+        memset(this, 0, sizeof(*this));
+        flags       = item.flags;
+        special     = item.special;
+        plus        = item.plus;
+        plus2       = item.plus2;
+        quantity    = item.quantity;
+        orig_monnum = item.orig_monnum;
+        base_type   = item.base_type;
+        sub_type    = item.sub_type;
+        type_id     = item_type_has_ids(item.base_type)
+                      ? you.type_ids[item.base_type][item.sub_type]
+                      : ID_UNKNOWN_TYPE;
+    }
+
+    bool operator<(const autopickup_key &other) const
+    {
+        return memcmp(this, &other, sizeof(*this)) < 0;
+    }
+
+    iflags_t flags;
+    int special;
+    short plus;
+    short plus2;
+    short quantity;
+    short orig_monnum;
+    uint8_t base_type;
+    uint8_t sub_type;
+    uint8_t type_id;
+};
+
+#define AUTOPICKUP_CACHE_SIZE 1024
+static map<autopickup_key, bool> autopickup_cache;
+static uint32_t autopickup_cache_player;
+
+// Returns true if the given Lua autopickup hook might say anything: either
+// an rc file has replaced userbase.lua's version of it, or the list that
+// version walks (see add_autopickup_func()) isn't empty.
+static bool _lua_autopickup_hook(const char *fn, const char *list)
+{
+#ifdef CLUA_BINDINGS
+    lua_State *ls = clua.state();
+    if (!ls)
+        return false;
+
+    lua_stack_cleaner clean(ls);
+    lua_getglobal(ls, fn);
+    if (lua_isnil(ls, -1))
+        return false;
+    clua.getregistry(fn);
+    if (!lua_rawequal(ls, -1, -2))
+        return true;
+
+    lua_getglobal(ls, list);
+    return !lua_istable(ls, -1) || lua_objlen(ls, -1);
+#else
+    return false;
+#endif
+}
+
+static void _compile_autopickup_table()
+{
+    if (autopickup_table_valid
+        && autopickup_table_generation == Options.generation)
+    {
+        return;
+    }
 
+    bool can_force = false, can_deny = false;
+    for (unsigned int i = 0; i < Options.force_autopickup.size(); ++i)
+        (Options.force_autopickup[i].second ? can_force : can_deny) = true;
+
+    for (int i = 0; i < NUM_OBJECT_CLASSES; ++i)
+    {
+        if (Options.autopickups[i])
+            autopickup_table[i] = can_deny ? AP_BY_NAME : AP_YES;
+        else
+            autopickup_table[i] = can_force ? AP_BY_NAME : AP_NO;
+    }
+
+    autopickup_cache.clear();
+    autopickup_table_valid = true;
+    autopickup_table_generation = Options.generation;
+}
+
+// Everything about the player that item_prefix() and the search
+// annotations look at.
+static uint32_t _autopickup_player_stamp()
+{
+    const int32_t state[] =
+    {
+        you.species, you.religion, you.form, you.hunger_state,
+        you.num_turns == 0,
+    };
+    uint32_t hash = hash32(state, sizeof(state));
+    hash = hash * 31 + hash32(&you.mutation[0], NUM_MUTATIONS);
+    hash = hash * 31 + hash32(&you.equip[0], NUM_EQUIP);
+    hash = hash * 31 + hash32(&you.spells[0],
+                              MAX_KNOWN_SPELLS * sizeof(you.spells[0]));
+    return hash;
+}
+
+static bool _is_name_autopickup(const item_def &item, string &iname);
+
+static bool _is_option_autopickup(const item_def &item, string &iname)
+{
     if (item.base_type < NUM_OBJECT_CLASSES)
     {
         const int force = you.force_autopickup[item.base_type][_autopickup_subtype(item)];
@@ -2559,6 +2713,56 @@ static bool _is_option_autopickup(const item_def &item, string &iname)
     else
         return false;
 
+    _compile_autopickup_table();
+    const bool force_hook = _lua_autopickup_hook("ch_force_autopickup",
+                                                 "chk_force_autopickup");
+    const bool deny_hook = _lua_autopickup_hook("ch_deny_autopickup",
+                                                "chk_deny_autopickup");
+    switch (autopickup_table[item.base_type])
+    {
+    case AP_NO:
+        if (!force_hook)
+            return false;
+        break;
+    case AP_YES:
+        if (!deny_hook)
+            return true;
+        break;
+    default:
+        break;
+    }
+
+    // Lua hooks may look at anything, and artefacts, inscriptions and
+    // properties all show up in item names without being in the key.
+    if (force_hook || deny_hook || is_artefact(item)
+        || !item.inscription.empty() || !item.props.empty())
+    {
+        return _is_name_autopickup(item, iname);
+    }
+
+    const uint32_t player = _autopickup_player_stamp();
+    if (player != autopickup_cache_player
+        || autopickup_cache.size() >= AUTOPICKUP_CACHE_SIZE)
+    {
+        autopickup_cache.clear();
+        autopickup_cache_player = player;
+    }
+
+    const autopickup_key key(item);
+    map<autopickup_key, bool>::const_iterator i = autopickup_cache.find(key);
+    if (i != autopickup_cache.end())
+        return i->second;
+
+    const bool pickup = _is_name_autopickup(item, iname);
+    autopickup_cache[key] = pickup;
+    return pickup;
+}
+
+static bool _is_name_autopickup(const item_def &item, string &iname)
+{
+    if (iname.empty())
+        iname = _autopickup_item_name(item);
+
     //Check for initial settings
     for (int i = 0; i < (int)Options.force_autopickup.size(); ++i)
         if (Options.force_autopickup[i].first.matches(iname))
@@ -3120,6 +3324,14 @@ int item_def::index() const
     return this - mitm.buffer();
 }
 
+void item_def::clear()
+{
+    *this = item_def();
+
+    if (this >= mitm.buffer() && this < mitm.buffer() + MAX_ITEMS)
+        env.free_items.set(index());
+}
+
 int item_def::armour_rating() const
 {
     if (!defined() || base_type != OBJ_ARMOUR)
@@ -39,17 +39,11 @@ module "crawl"
 #include "religion.h"
 #include "state.h"
 #include "stuff.h"
+#include "syscalls.h"
 #include "tutorial.h"
 #include "view.h"
 #include "worley.h"
 
-#ifdef TARGET_OS_WINDOWS
-# include "windows.h"
-#else
-# include <sys/time.h>
-# include <time.h>
-#endif
-
 /////////////////////////////////////////////////////////////////////
 // User accessible
 //
@@ -1107,21 +1101,7 @@ LUAFN(_crawl_redraw_stats)
 
 LUAFN(_crawl_millis)
 {
-#ifdef TARGET_OS_WINDOWS
-    // MSVC has no gettimeofday().
-    FILETIME ft;
-    GetSystemTimeAsFileTime(&ft);
-    uint64_t tt = ft.dwHighDateTime;
-    tt <<= 32;
-    tt |= ft.dwLowDateTime;
-    tt /= 10000;
-    tt -= 11644473600000ULL;
-    lua_pushnumber(ls, tt);
-#else
-    struct timeval tv;
-    gettimeofday(&tv, nullptr);
-    lua_pushnumber(ls, tv.tv_sec * 1000 + tv.tv_usec / 1000);
-#endif
+    lua_pushnumber(ls, get_time_usec() / 1000);
     return 1;
 }
 
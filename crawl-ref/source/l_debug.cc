@@ -13,6 +13,7 @@
 #include "branch.h"
 #include "chardump.h"
 #include "coordit.h"
+#include "dlua.h"
 #include "dungeon.h"
 #include "env.h"
 #include "files.h"
@@ -359,6 +360,37 @@ LUAFN(debug_disable)
     return 0;
 }
 
+// Returns the number of regexes compiled so far, and the number of compiles
+// avoided by sharing already compiled ones.
+LUAFN(debug_pattern_stats)
+{
+    lua_pushnumber(ls, text_pattern::compiles);
+    lua_pushnumber(ls, text_pattern::cache_hits);
+    return 2;
+}
+
+// Returns the bytes in use by the user Lua VM (or by the dungeon builder's,
+// if the argument is true), the most it has used, and the number of
+// allocations it made in all and during the last turn.
+LUAFN(debug_lua_memory_stats)
+{
+    CLua &vm = lua_toboolean(ls, 1) ? dlua : clua;
+    lua_pushnumber(ls, vm.memory_used);
+    lua_pushnumber(ls, vm.memory_peak);
+    lua_pushnumber(ls, vm.n_allocs);
+    lua_pushnumber(ls, vm.last_turn_allocs());
+    return 4;
+}
+
+// Timings of the user's own (clua) hooks; reset them afterwards if asked.
+LUAFN(debug_profile_report)
+{
+    lua_pushstring(ls, clua.profile_report().c_str());
+    if (lua_toboolean(ls, 1))
+        clua.reset_profile();
+    return 1;
+}
+
 const struct luaL_reg debug_dlib[] =
 {
 { "goto_place", debug_goto_place },
@@ -384,5 +416,8 @@ const struct luaL_reg debug_dlib[] =
 { "viewwindow", debug_viewwindow },
 { "seen_monsters_react", debug_seen_monsters_react },
 { "disable", debug_disable },
+{ "pattern_stats", debug_pattern_stats },
+{ "lua_memory_stats", debug_lua_memory_stats },
+{ "profile_report", debug_profile_report },
 { NULL, NULL }
 };
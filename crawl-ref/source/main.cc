@@ -499,6 +499,7 @@ static void _show_commandline_options_help()
     puts("  -macro <dir>          directory to save/find macro.txt");
     puts("  -version              Crawl version (and compilation info)");
     puts("  -save-version <name>  Save file version for the given player");
+    puts("  -savebench <name>     benchmark and verify save (de)serialization");
     puts("  -sprint               select Sprint");
     puts("  -sprint-map <name>    preselect a Sprint map");
     puts("  -tutorial             select the Tutorial");
@@ -689,6 +690,7 @@ static void _do_wizard_command(int wiz_command, bool silent_fail)
     case CONTROL('C'): die("Intentional crash");
 
     case 'O': debug_test_explore();                  break;
+    case 'l': debug_dump_lua_profile();              break;
     case 'S': wizard_set_skill_level();              break;
     case 'A': wizard_set_all_skills();               break;
     case 'a': acquirement(OBJ_RANDOM, AQ_WIZMODE);   break;
@@ -1903,8 +1903,8 @@ bool map_lines::fill_zone(travel_distance_grid_t &tpd, const coord_def &start,
                           const coord_def &tl, const coord_def &br, int zone,
                           const char *wanted, const char *passable) const
 {
-    // This is the map_lines equivalent of _dgn_fill_zone.
-    // It's unfortunately extremely similar, but not close enough to combine.
+    // This is the map_lines equivalent of _dgn_label_zones, one zone at a
+    // time; not close enough to combine.
 
     bool ret = false;
     list<coord_def> points[2];
@@ -2795,6 +2795,15 @@ string map_def::validate_map_def(const depth_ranges &default_depths)
     test_lua_validate(true);
     run_lua_epilogue(true);
 
+    // The veto chunk isn't run here, but compile it anyway so that the
+    // map cache stores its bytecode along with the others.
+    if (!veto.empty())
+    {
+        if (veto.load(dlua))
+            return veto.orig_error();
+        lua_pop(dlua, 1);
+    }
+
     if (!has_depth() && !lc_default_depths.empty())
         depths.add_depths(lc_default_depths);
 
@@ -879,6 +879,7 @@ bool melee_attack::handle_phase_damaged()
         {
             mpr("Your attached jelly is knocked off by the blow!");
             you.mutation[MUT_JELLY_GROWTH] = 0;
+            you.invalidate_stat_cache();
         }
     }
 
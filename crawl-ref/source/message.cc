@@ -170,72 +170,133 @@ struct message_item
     }
 };
 
-static int _mod(int num, int denom)
+// Stored messages, packed into a ring of bytes: each is a fixed-size header
+// followed by its text, so storing one doesn't allocate.  The oldest
+// messages are dropped when either the bytes or the SIZE slots run out.
+//
+// Indices work like circ_vec's used to: 0 is the oldest message and -1 the
+// newest.  Out of range indices give an empty message_item.
+template <int SIZE, int BYTES>
+class message_history
 {
-    ASSERT(denom > 0);
-    div_t res = div(num, denom);
-    return res.rem >= 0 ? res.rem : res.rem + denom;
-}
+    struct header
+    {
+        int32_t param;
+        int32_t repeats;
+        int32_t turn;
+        int32_t channel;
+        uint32_t length;
+    };
 
-template <typename T, int SIZE>
-class circ_vec
-{
-    T data[SIZE];
+    char arena[BYTES];
+    uint32_t offsets[SIZE];   // of each message's header, in a ring
+    int first;                // slot of the oldest message
+    int count;
 
-    int end;   // first unfilled index
+    static uint32_t record_size(uint32_t length)
+    {
+        return sizeof(header) + length;
+    }
 
-    static void inc(int* index)
+    header header_at(int slot) const
     {
-        ASSERT_RANGE(*index, 0, SIZE);
-        *index = _mod(*index + 1, SIZE);
+        header h;
+        memcpy(&h, &arena[offsets[slot]], sizeof(h));
+        return h;
     }
 
-    static void dec(int* index)
+    // The slot of the i'th message, or -1.
+    int slot(int i) const
     {
-        ASSERT_RANGE(*index, 0, SIZE);
-        *index = _mod(*index - 1, SIZE);
+        if (i < 0)
+            i += count;
+        if (i < 0 || i >= count)
+            return -1;
+        return (first + i) % SIZE;
+    }
+
+    uint32_t end_offset() const
+    {
+        if (!count)
+            return 0;
+        const int last = slot(-1);
+        return offsets[last] + record_size(header_at(last).length);
+    }
+
+    void pop_front()
+    {
+        first = (first + 1) % SIZE;
+        --count;
     }
 
 public:
-    circ_vec() : end(0) {}
+    message_history() : first(0), count(0) {}
 
     void clear()
     {
-        end = 0;
-        for (int i = 0; i < SIZE; ++i)
-            data[i] = T();
+        first = count = 0;
     }
 
     int size() const
     {
-        return SIZE;
+        return count;
     }
 
-    T& operator[](int i)
+    message_item operator[](int i) const
     {
-        ASSERT(_mod(i, SIZE) < size());
-        return data[_mod(end + i, SIZE)];
-    }
+        const int s = slot(i);
+        if (s == -1)
+            return message_item();
 
-    const T& operator[](int i) const
-    {
-        ASSERT(_mod(i, SIZE) < size());
-        return data[_mod(end + i, SIZE)];
+        const header h = header_at(s);
+        return message_item(string(&arena[offsets[s]] + sizeof(header),
+                                   h.length),
+                            static_cast<msg_channel_type>(h.channel),
+                            h.param, h.repeats, h.turn);
     }
 
-    void push_back(const T& item)
+    void push_back(const message_item &item)
     {
-        data[end] = item;
-        inc(&end);
+        uint32_t length = min(item.text.length(), (size_t)BYTES / 4);
+        // Don't cut a UTF-8 character in half.
+        if (length < item.text.length())
+            while (length && (item.text[length] & 0xC0) == 0x80)
+                --length;
+        const uint32_t need = record_size(length);
+
+        uint32_t pos = end_offset();
+        if (pos + need > BYTES)
+        {
+            // Drop whatever is still stored past the newest message, and
+            // carry on from the start of the arena.
+            while (count && offsets[first] >= pos)
+                pop_front();
+            pos = 0;
+        }
+        // Live messages past pos are in order, oldest first.
+        while (count && (count == SIZE
+                         || offsets[first] >= pos
+                            && offsets[first] < pos + need))
+        {
+            pop_front();
+        }
+
+        header h;
+        h.param   = item.param;
+        h.repeats = item.repeats;
+        h.turn    = item.turn;
+        h.channel = item.channel;
+        h.length  = length;
+        memcpy(&arena[pos], &h, sizeof(h));
+        memcpy(&arena[pos + sizeof(h)], item.text.data(), length);
+
+        offsets[(first + count) % SIZE] = pos;
+        ++count;
     }
 
     void roll_back(int n)
     {
-        for (int i = 0; i < n; ++i)
-        {
-            dec(&end);
-            data[end] = T();
-        }
+        count = max(0, count - n);
     }
 };
 
@@ -626,7 +687,7 @@ bool any_messages()
     return msgwin.any_messages();
 }
 
-typedef circ_vec<message_item, NUM_STORED_MESSAGES> store_t;
+typedef message_history<NUM_STORED_MESSAGES, MESSAGE_HISTORY_BYTES> store_t;
 
 class message_store
 {
@@ -761,7 +822,7 @@ public:
         tiles.json_open_array("messages");
         for (int i = -unsent; i < (send_ignore_one ? -1 : 0); ++i)
         {
-            message_item& msg = msgs[i];
+            const message_item msg = msgs[i];
             tiles.json_open_object();
             tiles.json_write_string("text", msg.text);
             tiles.json_write_int("turn", msg.turn);
@@ -1092,11 +1153,76 @@ void dprf(diag_type param, const char *format, ...)
 
 static bool _updating_view = false;
 
+// Every message option pattern, matched together so that each message is
+// scanned once no matter how many of them the rc file sets up.  Rebuilt
+// whenever the options change.
+static pattern_set msg_patterns;
+static unsigned msg_patterns_generation = 0;
+static int more_base, note_base, sound_base, colour_base;
+
+// The same message is usually looked up several times in a row.
+static string last_matched_msg;
+static vector<bool> last_matches;
+static bool last_matches_valid = false;
+
+static void _build_message_patterns()
+{
+    msg_patterns.clear();
+
+    more_base = msg_patterns.size();
+    for (unsigned i = 0; i < Options.force_more_message.size(); ++i)
+        msg_patterns.add(Options.force_more_message[i].pattern);
+
+    note_base = msg_patterns.size();
+    for (unsigned i = 0; i < Options.note_messages.size(); ++i)
+        msg_patterns.add(Options.note_messages[i]);
+
+    sound_base = msg_patterns.size();
+    for (unsigned i = 0; i < Options.sound_mappings.size(); ++i)
+        msg_patterns.add(Options.sound_mappings[i].pattern);
+
+    colour_base = msg_patterns.size();
+    for (unsigned i = 0; i < Options.message_colour_mappings.size(); ++i)
+        msg_patterns.add(Options.message_colour_mappings[i].message.pattern);
+
+    msg_patterns_generation = Options.generation;
+    last_matches_valid = false;
+}
+
+static const vector<bool>& _match_message_patterns(const string& msg)
+{
+    if (msg_patterns_generation != Options.generation)
+        _build_message_patterns();
+
+    if (!last_matches_valid || msg != last_matched_msg)
+    {
+        msg_patterns.match(msg, last_matches);
+        last_matched_msg = msg;
+        last_matches_valid = true;
+    }
+    return last_matches;
+}
+
+// Like message_filter::is_filtered(), with the pattern already matched.
+static bool _filter_matches(const message_filter &mf, int channel,
+                            bool pattern_matched)
+{
+    if (channel != mf.channel && mf.channel != -1)
+        return false;
+    return mf.pattern.empty() || pattern_matched;
+}
+
 static bool check_more(const string& line, msg_channel_type channel)
 {
+    const vector<bool> &matched = _match_message_patterns(line);
     for (unsigned i = 0; i < Options.force_more_message.size(); ++i)
-        if (Options.force_more_message[i].is_filtered(channel, line))
+    {
+        if (_filter_matches(Options.force_more_message[i], channel,
+                            matched[more_base + i]))
+        {
             return true;
+        }
+    }
     return false;
 }
 
@@ -1375,6 +1501,8 @@ static void mpr_check_patterns(const string& message,
                                msg_channel_type channel,
                                int param)
 {
+    const vector<bool> &matched = _match_message_patterns(message);
+
     for (unsigned i = 0; i < Options.note_messages.size(); ++i)
     {
         if (channel == MSGCH_EQUIPMENT || channel == MSGCH_FLOOR_ITEMS
@@ -1385,7 +1513,7 @@ static void mpr_check_patterns(const string& message,
             continue;
         }
 
-        if (Options.note_messages[i].matches(message))
+        if (matched[note_base + i])
         {
             take_note(Note(NOTE_MESSAGE, channel, param, message.c_str()));
             break;
@@ -1400,16 +1528,20 @@ static void mpr_check_patterns(const string& message,
         you.check_awaken(5);
 
     if (!Options.sound_mappings.empty())
+    {
+        // Refetch: noting or interrupting may have printed messages.
+        const vector<bool> &sounds = _match_message_patterns(message);
         for (unsigned i = 0; i < Options.sound_mappings.size(); i++)
         {
             // Maybe we should allow message channel matching as for
             // force_more_message?
-            if (Options.sound_mappings[i].pattern.matches(message))
+            if (sounds[sound_base + i])
             {
                 play_sound(Options.sound_mappings[i].soundfile.c_str());
                 break;
             }
         }
+    }
 }
 
 static bool channel_message_history(msg_channel_type channel)
@@ -1447,13 +1579,13 @@ static msg_colour_type prepare_message(const string& imsg,
 
     const vector<message_colour_mapping>& mcm
                = Options.message_colour_mappings;
-    typedef vector<message_colour_mapping>::const_iterator mcmci;
+    const vector<bool> &matched = _match_message_patterns(imsg);
 
-    for (mcmci ci = mcm.begin(); ci != mcm.end(); ++ci)
+    for (unsigned i = 0; i < mcm.size(); ++i)
     {
-        if (ci->message.is_filtered(channel, imsg))
+        if (_filter_matches(mcm[i].message, channel, matched[colour_base + i]))
         {
-            colour = ci->colour;
+            colour = mcm[i].colour;
             break;
         }
     }
@@ -1579,8 +1711,6 @@ string get_last_messages(int mcount, bool full)
     string text;
     // XXX: should use some message_history iterator here
     const store_t& msgs = buffer.get_store();
-    // XXX: loop wraps around otherwise. This could be done better.
-    mcount = min(mcount, NUM_STORED_MESSAGES);
     for (int i = -1; mcount > 0; --i)
     {
         const message_item msg = msgs[i];
@@ -1603,8 +1733,7 @@ void get_recent_messages(vector<string> &mess,
     flush_prev_message();
 
     const store_t& msgs = buffer.get_store();
-    int mcount = NUM_STORED_MESSAGES;
-    for (int i = -1; mcount > 0; --i, --mcount)
+    for (int i = -1; i >= -msgs.size(); --i)
     {
         const message_item msg = msgs[i];
         if (!msg)
@@ -1614,19 +1743,18 @@ void get_recent_messages(vector<string> &mess,
     }
 }
 
-// We just write out the whole message store including empty/unused
-// messages. They'll be ignored when restoring.
 void save_messages(writer& outf)
 {
-    store_t msgs = buffer.get_store();
+    const store_t& msgs = buffer.get_store();
     marshallInt(outf, msgs.size());
     for (int i = 0; i < msgs.size(); ++i)
     {
-        marshallString4(outf, msgs[i].text);
-        marshallInt(outf, msgs[i].channel);
-        marshallInt(outf, msgs[i].param);
-        marshallInt(outf, msgs[i].repeats);
-        marshallInt(outf, msgs[i].turn);
+        const message_item msg = msgs[i];
+        marshallString4(outf, msg.text);
+        marshallInt(outf, msg.channel);
+        marshallInt(outf, msg.param);
+        marshallInt(outf, msg.repeats);
+        marshallInt(outf, msg.turn);
     }
 }
 
@@ -1659,11 +1787,14 @@ void replay_messages(void)
     formatted_scroller hist(MF_START_AT_END | MF_ALWAYS_SHOW_MORE, "");
     hist.set_more();
 
-    const store_t msgs = buffer.get_store();
+    const store_t& msgs = buffer.get_store();
+    message_item msg = msgs[0];
     for (int i = 0; i < msgs.size(); ++i)
-        if (channel_message_history(msgs[i].channel))
+    {
+        const message_item next = msgs[i + 1];
+        if (channel_message_history(msg.channel))
         {
-            string text = msgs[i].with_repeats();
+            string text = msg.with_repeats();
             linebreak_string(text, cgetsize(GOTO_CRT).x - 1);
             vector<formatted_string> parts;
             formatted_string::parse_string_to_multiple(text, parts);
@@ -1671,16 +1802,15 @@ void replay_messages(void)
             {
                 formatted_string line;
                 prefix_type p = P_NONE;
-                if (j == parts.size() - 1 && i + 1 < msgs.size()
-                    && msgs[i+1].turn > msgs[i].turn)
-                {
+                if (j == parts.size() - 1 && next && next.turn > msg.turn)
                     p = P_TURN_END;
-                }
                 line.add_glyph(_prefix_glyph(p));
                 line += parts[j];
                 hist.add_item_formatted_string(line);
             }
         }
+        msg = next;
+    }
 
     hist.show();
 }
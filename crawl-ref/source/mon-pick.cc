@@ -118,8 +118,6 @@ monster_type pick_monster(level_id place, monster_picker &picker, mon_pick_vetoe
 monster_type pick_monster_from(const pop_entry *fpop, int depth,
                                mon_pick_vetoer veto)
 {
-    // XXX: If creating/destroying instances has performance issues, cache a
-    // static instance
     monster_picker picker = monster_picker();
     return picker.pick_with_veto(fpop, depth, MONS_0, veto);
 }
@@ -156,17 +154,35 @@ monster_type pick_monster_all_branches(int absdepth0, mon_pick_vetoer veto)
     return pick_monster_all_branches(absdepth0, picker, veto);
 }
 
-// Used for picking zombies when there's nothing native.
-// TODO: cache potential zombifiables for the given level/size, with a
-// second pass to select ones that have a skeleton/etc and can be placed in
-// a given spot.
-monster_type pick_monster_all_branches(int absdepth0, monster_picker &picker,
-                                       mon_pick_vetoer veto)
+// Applies either the explicit veto, or failing that the picker's own.
+struct all_branches_vetoer
 {
-    monster_type valid[NUM_MONSTERS];
+    all_branches_vetoer(monster_picker &_picker, mon_pick_vetoer _veto)
+        : picker(_picker), veto(_veto) { }
+
+    bool operator()(monster_type mon)
+    {
+        return veto ? (*veto)(mon) : picker.veto(mon);
+    }
+
+    monster_picker &picker;
+    mon_pick_vetoer veto;
+};
+
+// Every branch the given absolute depth falls into, each monster at its
+// best rarity among them.  Built on first use for each depth.
+static const random_pick_table<monster_type> &
+_all_branches_table(int absdepth0, monster_picker &picker)
+{
+    static map<int, random_pick_table<monster_type> > tables;
+
+    map<int, random_pick_table<monster_type> >::iterator it
+        = tables.find(absdepth0);
+    if (it != tables.end())
+        return it->second;
+
     int rarities[NUM_MONSTERS];
     memset(rarities, 0, sizeof(rarities));
-    int nvalid = 0;
 
     for (int br = 0; br < NUM_BRANCHES; br++)
     {
@@ -179,35 +195,28 @@ monster_type pick_monster_all_branches(int absdepth0, monster_picker &picker,
             if (depth < pop->minr || depth > pop->maxr)
                 continue;
 
-            if (veto && (*veto)(pop->value)
-                || !veto && picker.veto(pop->value))
-                continue;
-
             int rar = picker.rarity_at(pop, depth);
             ASSERT(rar > 0);
 
-            monster_type mons = pop->value;
-            if (!rarities[mons])
-                valid[nvalid++] = pop->value;
-            if (rarities[mons] < rar)
-                rarities[mons] = rar;
+            if (rarities[pop->value] < rar)
+                rarities[pop->value] = rar;
         }
     }
 
-    if (!nvalid)
-        return MONS_0;
-
-    int totalrar = 0;
-    for (int i = 0; i < nvalid; i++)
-        totalrar += rarities[valid[i]];
-
-    totalrar = random2(totalrar); // the roll!
-
-    for (int i = 0; i < nvalid; i++)
-        if ((totalrar -= rarities[valid[i]]) < 0)
-            return valid[i];
+    random_pick_table<monster_type> &table = tables[absdepth0];
+    for (monster_type mons = MONS_0; mons < NUM_MONSTERS; ++mons)
+        if (rarities[mons])
+            table.add(mons, rarities[mons]);
+    table.build();
+    return table;
+}
 
-    die("mon-pick roll out of range");
+// Used for picking zombies when there's nothing native.
+monster_type pick_monster_all_branches(int absdepth0, monster_picker &picker,
+                                       mon_pick_vetoer veto)
+{
+    all_branches_vetoer vetoer(picker, veto);
+    return _all_branches_table(absdepth0, picker).pick(vetoer, MONS_0);
 }
 
 bool branch_has_monsters(branch_type branch)
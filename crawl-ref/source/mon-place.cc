@@ -1154,16 +1154,43 @@ monster* place_monster(mgen_data mg, bool force_pos, bool dont_place)
     return mon;
 }
 
-monster* get_free_monster()
+// Finds the lowest free slot on the free list.  Slots stay listed until
+// they are seen in use, so one that a caller took but never filled is
+// handed out again, just as the old linear scan did.
+static int _first_monster_slot()
 {
-    for (int i = 0; i < MAX_MONSTERS; ++i)
+    for (int i = env.free_mons.first(); i != -1; i = env.free_mons.first())
+    {
         if (env.mons[i].type == MONS_NO_MONSTER)
-        {
-            env.mons[i].reset();
-            return &env.mons[i];
-        }
+            return i;
+        env.free_mons.set(i, false);
+    }
+
+    return -1;
+}
+
+// Puts every unused slot back on the free list, whether or not it got there
+// through monster::reset().
+void rebuild_free_monsters()
+{
+    for (int i = 0; i < MAX_MONSTERS; ++i)
+        env.free_mons.set(i, env.mons[i].type == MONS_NO_MONSTER);
+}
+
+monster* get_free_monster()
+{
+    int i = _first_monster_slot();
+    if (i == -1)
+    {
+        rebuild_free_monsters();
+        i = _first_monster_slot();
+    }
+
+    if (i == -1)
+        return NULL;
 
-    return NULL;
+    env.mons[i].reset();
+    return &env.mons[i];
 }
 
 void mons_add_blame(monster* mon, const string &blame_string)
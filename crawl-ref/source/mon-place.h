@@ -102,6 +102,7 @@ void set_vault_mon_list(const vector<mons_spec> &list);
 void setup_vault_mon_list();
 
 monster* get_free_monster();
+void rebuild_free_monsters();
 
 bool can_place_on_trap(monster_type mon_type, trap_type trap);
 bool mons_airborne(monster_type mcls, int flies, bool paralysed);
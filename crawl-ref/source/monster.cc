@@ -85,6 +85,7 @@ monster::monster()
     constricting = 0;
 
     clear_constricted();
+    resist_cache.filled = false;
 };
 
 // Empty destructor to keep unique_ptr happy with incomplete ghost_demon type.
@@ -144,6 +145,7 @@ void monster::reset()
     travel_target = MTRAV_NONE;
     travel_path.clear();
     ghost.reset(NULL);
+    resist_cache.filled = false;
     seen_context = SC_NONE;
     props.clear();
     clear_constricted();
@@ -155,6 +157,9 @@ void monster::reset()
     // Just for completeness.
     speed           = 0;
     colour          = 0;
+
+    if (this >= menv.buffer() && this < menv.buffer() + MAX_MONSTERS)
+        env.free_mons.set(mindex());
 }
 
 void monster::init_with(const monster& mon)
@@ -3653,6 +3658,90 @@ bool monster::is_insubstantial() const
     return mons_class_flag(type, M_INSUBSTANTIAL);
 }
 
+void monster::invalidate_resist_cache()
+{
+    resist_cache.filled = false;
+}
+
+static void _resist_cache_stamp(const monster *mon,
+                                mon_resist_cache::stamp_type &st)
+{
+    static const mon_inv_type slots[] =
+    {
+        MSLOT_WEAPON, MSLOT_ALT_WEAPON, MSLOT_ARMOUR, MSLOT_SHIELD,
+        MSLOT_JEWELLERY,
+    };
+    static const enchant_type enchs[] =
+    {
+        ENCH_FIRE_VULN, ENCH_LOWERED_MR, ENCH_RAISED_MR,
+    };
+    COMPILE_CHECK(ARRAYSZ(slots) == ARRAYSZ(st.inv));
+
+    memset(&st, 0, sizeof(st));
+    st.type         = mon->type;
+    st.base_monster = mon->base_monster;
+    st.hit_dice     = mon->hit_dice;
+    for (unsigned int i = 0; i < ARRAYSZ(slots); ++i)
+        st.inv[i] = mon->inv[slots[i]];
+    for (unsigned int i = 0; i < ARRAYSZ(enchs); ++i)
+        if (mon->has_ench(enchs[i]))
+            st.enchs |= 1 << i;
+    if (testbits(mon->flags, MF_FAKE_UNDEAD))
+        st.enchs |= 1 << ARRAYSZ(enchs);
+}
+
+// Returns true if the resistance is cached, setting val; otherwise the
+// caller works it out and hands it to cache_resist().
+bool monster::resist_cached(mon_cached_resist which, int &val) const
+{
+    mon_resist_cache &cache = resist_cache;
+
+    mon_resist_cache::stamp_type now;
+    _resist_cache_stamp(this, now);
+
+    if (!cache.filled)
+    {
+        // Tentacle segments use their head's resistances.
+        cache.usable = !is_child_tentacle_segment();
+        cache.filled = true;
+    }
+    else if (!memcmp(&now, &cache.stamp, sizeof(now)))
+    {
+#ifdef DEBUG_STAT_CACHE
+        // Always recompute; cache_resist() checks the result.
+        return false;
+#else
+        if (!cache.usable || !(cache.known & (1 << which)))
+            return false;
+        val = cache.value[which];
+        return true;
+#endif
+    }
+
+    cache.stamp = now;
+    cache.known = 0;
+    return false;
+}
+
+int monster::cache_resist(mon_cached_resist which, int val) const
+{
+    mon_resist_cache &cache = resist_cache;
+    if (!cache.usable)
+        return val;
+
+#ifdef DEBUG_STAT_CACHE
+    if (cache.known & (1 << which))
+    {
+        ASSERTM(cache.value[which] == val,
+                "stale cached resist %d for %s: %d, should be %d", which,
+                name(DESC_PLAIN, true).c_str(), cache.value[which], val);
+    }
+#endif
+    cache.value[which] = val;
+    cache.known |= 1 << which;
+    return val;
+}
+
 int monster::res_hellfire() const
 {
     return get_mons_resist(this, MR_RES_FIRE) >= 4;
@@ -3660,7 +3749,11 @@ int monster::res_hellfire() const
 
 int monster::res_fire() const
 {
-    int u = get_mons_resist(this, MR_RES_FIRE);
+    int u;
+    if (resist_cached(MCR_FIRE, u))
+        return u;
+
+    u = get_mons_resist(this, MR_RES_FIRE);
 
     if (mons_itemuse(this) >= MONUSE_STARTING_EQUIPMENT)
     {
@@ -3692,12 +3785,16 @@ int monster::res_fire() const
     else if (u > 3)
         u = 3;
 
-    return u;
+    return cache_resist(MCR_FIRE, u);
 }
 
 int monster::res_steam() const
 {
-    int res = get_mons_resist(this, MR_RES_STEAM);
+    int res;
+    if (resist_cached(MCR_STEAM, res))
+        return res;
+
+    res = get_mons_resist(this, MR_RES_STEAM);
     if (wearing(EQ_BODY_ARMOUR, ARM_STEAM_DRAGON_ARMOUR))
         res += 3;
 
@@ -3706,12 +3803,16 @@ int monster::res_steam() const
     if (res > 3)
         res = 3;
 
-    return res;
+    return cache_resist(MCR_STEAM, res);
 }
 
 int monster::res_cold() const
 {
-    int u = get_mons_resist(this, MR_RES_COLD);
+    int u;
+    if (resist_cached(MCR_COLD, u))
+        return u;
+
+    u = get_mons_resist(this, MR_RES_COLD);
 
     if (mons_itemuse(this) >= MONUSE_STARTING_EQUIPMENT)
     {
@@ -3740,15 +3841,17 @@ int monster::res_cold() const
     else if (u > 3)
         u = 3;
 
-    return u;
+    return cache_resist(MCR_COLD, u);
 }
 
 int monster::res_elec() const
 {
     // This is a variable, not a player_xx() function, so can be above 1.
-    int u = 0;
+    int u;
+    if (resist_cached(MCR_ELEC, u))
+        return u;
 
-    u += get_mons_resist(this, MR_RES_ELEC);
+    u = get_mons_resist(this, MR_RES_ELEC);
 
     // Don't bother checking equipment if the monster can't use it.
     if (mons_itemuse(this) >= MONUSE_STARTING_EQUIPMENT)
@@ -3774,7 +3877,7 @@ int monster::res_elec() const
 
     // Monsters can legitimately get multiple levels of electricity resistance.
 
-    return u;
+    return cache_resist(MCR_ELEC, u);
 }
 
 int monster::res_asphyx() const
@@ -3806,10 +3909,14 @@ int monster::res_poison(bool temp) const
 {
     UNUSED(temp);
 
-    int u = get_mons_resist(this, MR_RES_POISON);
-    if (u > 0)
+    int u;
+    if (resist_cached(MCR_POISON, u))
         return u;
 
+    u = get_mons_resist(this, MR_RES_POISON);
+    if (u > 0)
+        return cache_resist(MCR_POISON, u);
+
     if (mons_itemuse(this) >= MONUSE_STARTING_EQUIPMENT)
     {
         u += scan_artefacts(ARTP_POISON);
@@ -3834,26 +3941,32 @@ int monster::res_poison(bool temp) const
 
     // Monsters can have multiple innate levels of poison resistance, but
     // like players, equipment doesn't stack.
-    if (u > 0)
-        return 1;
-    return u;
+    return cache_resist(MCR_POISON, u > 0 ? 1 : u);
 }
 
 int monster::res_sticky_flame() const
 {
-    int res = get_mons_resist(this, MR_RES_STICKY_FLAME);
+    int res;
+    if (resist_cached(MCR_STICKY_FLAME, res))
+        return res;
+
+    res = get_mons_resist(this, MR_RES_STICKY_FLAME);
     if (is_insubstantial())
         res += 1;
     if (wearing(EQ_BODY_ARMOUR, ARM_MOTTLED_DRAGON_ARMOUR))
         res += 1;
-    return res;
+    return cache_resist(MCR_STICKY_FLAME, res);
 }
 
 int monster::res_rotting(bool temp) const
 {
     UNUSED(temp);
 
-    int res = 0;
+    int res;
+    if (resist_cached(MCR_ROTTING, res))
+        return res;
+
+    res = 0;
     switch (holiness())
     {
     case MH_NATURAL:
@@ -3879,7 +3992,7 @@ int monster::res_rotting(bool temp) const
     if (get_mons_resist(this, MR_RES_ROTTING))
         res += 1;
 
-    return min(3, res);
+    return cache_resist(MCR_ROTTING, min(3, res));
 }
 
 int monster::res_holy_energy(const actor *attacker) const
@@ -3907,10 +4020,14 @@ int monster::res_holy_energy(const actor *attacker) const
 
 int monster::res_negative_energy(bool intrinsic_only) const
 {
+    int u;
+    if (!intrinsic_only && resist_cached(MCR_NEGATIVE_ENERGY, u))
+        return u;
+
     if (holiness() != MH_NATURAL)
-        return 3;
+        return intrinsic_only ? 3 : cache_resist(MCR_NEGATIVE_ENERGY, 3);
 
-    int u = get_mons_resist(this, MR_RES_NEG);
+    u = get_mons_resist(this, MR_RES_NEG);
 
     if (mons_itemuse(this) >= MONUSE_STARTING_EQUIPMENT && !intrinsic_only)
     {
@@ -3937,7 +4054,7 @@ int monster::res_negative_energy(bool intrinsic_only) const
     if (u > 3)
         u = 3;
 
-    return u;
+    return intrinsic_only ? u : cache_resist(MCR_NEGATIVE_ENERGY, u);
 }
 
 int monster::res_torment() const
@@ -4018,10 +4135,14 @@ int monster::res_acid(bool calc_unid) const
 
 int monster::res_magic() const
 {
+    int u;
+    if (resist_cached(MCR_MAGIC, u))
+        return u;
+
     if (mons_immune_magic(this))
-        return MAG_IMMUNE;
+        return cache_resist(MCR_MAGIC, MAG_IMMUNE);
 
-    int u = (get_monster_data(type))->resist_magic;
+    u = (get_monster_data(type))->resist_magic;
 
     // Negative values get multiplied with monster hit dice.
     if (u < 0)
@@ -4053,7 +4174,7 @@ int monster::res_magic() const
     if (u < 0)
         u = 0;
 
-    return u;
+    return cache_resist(MCR_MAGIC, u);
 }
 
 bool monster::no_tele(bool calc_unid, bool permit_id, bool blinking) const
@@ -4382,6 +4503,7 @@ void monster::slow_down(actor *atk, int strength)
 void monster::set_ghost(const ghost_demon &g)
 {
     ghost.reset(new ghost_demon(g));
+    invalidate_resist_cache();
 
     if (!ghost->name.empty())
         mname = ghost->name;
@@ -4425,6 +4547,8 @@ void monster::ghost_init(bool need_pos)
 
 void monster::uglything_init(bool only_mutate)
 {
+    invalidate_resist_cache();
+
     // If we're mutating an ugly thing, leave its experience level, hit
     // dice and maximum and current hit points as they are.
     if (!only_mutate)
@@ -4443,6 +4567,8 @@ void monster::uglything_init(bool only_mutate)
 
 void monster::ghost_demon_init()
 {
+    invalidate_resist_cache();
+
     // Unequip weapon before setting stats, in case of protection/evasion.
     item_def *wpn = weapon();
     if (wpn)
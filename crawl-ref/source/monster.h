@@ -13,6 +13,42 @@ typedef map<enchant_type, mon_enchant> mon_enchant_list;
 
 struct monsterentry;
 
+enum mon_cached_resist
+{
+    MCR_FIRE,
+    MCR_STEAM,
+    MCR_COLD,
+    MCR_ELEC,
+    MCR_POISON,
+    MCR_STICKY_FLAME,
+    MCR_ROTTING,
+    MCR_NEGATIVE_ENERGY,
+    MCR_MAGIC,
+    NUM_MON_CACHED_RESISTS
+};
+
+// Resistances worked out from the monster's type, ghost data, equipment
+// and enchantments.  The things they depend on are copied into the stamp
+// and compared on each lookup, except for ghost data, which is changed in
+// place and so must be followed by monster::invalidate_resist_cache().
+struct mon_resist_cache
+{
+    struct stamp_type
+    {
+        monster_type type;
+        monster_type base_monster;
+        int          hit_dice;
+        short        inv[5];     // weapons, armour, shield and jewellery
+        uint32_t     enchs;      // relevant flags and enchantments
+    };
+
+    bool       filled;
+    bool       usable;           // false for tentacle segments
+    stamp_type stamp;
+    uint32_t   known;            // bit per mon_cached_resist
+    int        value[NUM_MON_CACHED_RESISTS];
+};
+
 class monster : public actor
 {
 public:
@@ -73,6 +109,8 @@ public:
     uint32_t client_id;                // for ID of monster_info between turns
     static uint32_t last_client_id;
 
+    mutable mon_resist_cache resist_cache;
+
 public:
     void set_new_monster_id();
 
@@ -191,6 +229,8 @@ public:
     void set_originating_map(const string &);
 
     void set_ghost(const ghost_demon &ghost);
+    // Called by the *_init() functions after ghost data changes in place.
+    void invalidate_resist_cache();
     void ghost_init(bool need_pos = true);
     void ghost_demon_init();
     void uglything_init(bool only_mutate = false);
@@ -522,6 +562,9 @@ private:
 
     bool decay_enchantment(enchant_type en, bool decay_degree = true);
 
+    bool resist_cached(mon_cached_resist which, int &val) const;
+    int cache_resist(mon_cached_resist which, int val) const;
+
     bool wants_weapon(const item_def &item) const;
     bool wants_armour(const item_def &item) const;
     bool wants_jewellery(const item_def &item) const;
@@ -1619,6 +1619,7 @@ bool mutate(mutation_type which_mutation, const string &reason, bool failMsg,
                     // no need to redraw any stats or print any messages.
                     found = true;
                     you.mutation[mutat]--;
+                    you.invalidate_stat_cache();
                     break;
                 }
         if (!found)
@@ -1639,6 +1640,7 @@ bool mutate(mutation_type which_mutation, const string &reason, bool failMsg,
     bool gain_msg = true;
 
     you.mutation[mutat]++;
+    you.invalidate_stat_cache();
 
     // More than three messages, need to give them by hand.
     switch (mutat)
@@ -1803,6 +1805,7 @@ static bool _delete_single_mutation_level(mutation_type mutat,
     bool lose_msg = true;
 
     you.mutation[mutat]--;
+    you.invalidate_stat_cache();
 
     switch (mutat)
     {
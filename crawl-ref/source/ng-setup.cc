@@ -1436,6 +1436,9 @@ static void _setup_generic(const newgame_def& ng)
     _racialise_starting_equipment();
     initialise_item_descriptions();
 
+    // Equipment and mutations were set up by hand above.
+    you.invalidate_stat_cache();
+
     for (int i = 0; i < ENDOFPACK; ++i)
     {
         if (you.inv[i].defined())
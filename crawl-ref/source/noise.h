@@ -83,6 +83,10 @@ struct noise_cell
     int noise_intensity_millis;
     int noise_travel_distance;
 
+    // The noise_grid::generation this cell was last written in; cells from
+    // earlier generations are silent.
+    unsigned int generation;
+
     noise_cell();
     bool can_apply_noise(int noise_intensity_millis) const;
     bool apply_noise(int noise_intensity_millis,
@@ -147,10 +151,18 @@ private:
                                        const coord_def &affected_position,
                                        const noise_t &noise) const;
 
+    noise_cell &cell_at(const coord_def &pos);
+    const noise_cell &cell_at(const coord_def &pos) const;
+
 private:
     FixedArray<noise_cell, GXM, GYM> cells;
+    unsigned int generation;
     vector<noise_t> noises;
     int affected_actor_count;
+
+    // The cells to expand at the current and next travel distance, kept
+    // around so that their storage is reused from one turn to the next.
+    vector<coord_def> perimeter[2];
 };
 
 #endif
@@ -224,6 +224,9 @@ public:
 
     int         num_colours;     // used for setting up curses colour table (8 or 16)
 
+    bool        lua_profile;     // time Lua hooks and functions, for &l
+    int         lua_hook_budget; // ms a Lua hook may use per turn, 0 = no limit
+
 #ifdef WIZARD
     int            wiz_mode;   // no, never, start in wiz mode
     vector<string> terp_files; // Lua files to load for luaterp
@@ -233,6 +236,7 @@ public:
     // internal use only:
     int         sc_entries;      // # of score entries
     int         sc_format;       // Format for score entries
+    unsigned    generation;      // Bumped whenever options may have changed
 
     vector<pair<int, int> > hp_colour;
     vector<pair<int, int> > mp_colour;
@@ -34,6 +34,7 @@ Notes:
 #include "endianness.h"
 #include "errors.h"
 #include "syscalls.h"
+#include "threads.h"
 
 #if !defined(DGAMELAUNCH) && !defined(__ANDROID__) && !defined(DEBUG_DIAGNOSTICS)
 #define DO_FSYNC
@@ -81,11 +82,28 @@ typedef pair<plen_t, plen_t> bm_p;
 typedef map<plen_t, bm_p> bm_t;
 typedef map<plen_t, plen_t> fb_t;
 
+// Chunk readers may run on worker threads (see package::read_chunks()), and
+// a seek + read pair on a shared descriptor must not be interleaved.
+static mutex_t io_mutex;
+static bool io_mutex_inited = false;
+
+class io_lock
+{
+public:
+    io_lock()  { mutex_lock(io_mutex); }
+    ~io_lock() { mutex_unlock(io_mutex); }
+};
+
 package::package(const char* file, bool writeable, bool empty)
   : n_users(0), dirty(false), aborted(false), tmp(false)
 {
     dprintf("package: initializing file=\"%s\" rw=%d\n", file, writeable);
     ASSERT(writeable || !empty);
+    if (!io_mutex_inited)
+    {
+        mutex_init(io_mutex);
+        io_mutex_inited = true;
+    }
     filename = file;
     rw = writeable;
 
@@ -130,6 +148,11 @@ package::package()
 {
     dprintf("package: initializing tmp file\n");
     filename = "[tmp]";
+    if (!io_mutex_inited)
+    {
+        mutex_init(io_mutex);
+        io_mutex_inited = true;
+    }
 
     char file[7] = "XXXXXX";
     fd = mkstemp(file);
@@ -270,6 +293,17 @@ void package::seek(plen_t to)
         sysfail("failed to seek inside the save file");
 }
 
+void package::read_raw(plen_t at, void *data, plen_t len)
+{
+    io_lock lock;
+    seek(at);
+    ssize_t res = ::read(fd, data, len);
+    if (res < 0)
+        sysfail("error reading the save file");
+    if ((plen_t)res != len)
+        corrupted("save file corrupted -- block past eof");
+}
+
 chunk_writer* package::writer(const string name)
 {
     return new chunk_writer(this, name);
@@ -566,6 +600,85 @@ bool package::has_chunk(const string name)
     return !name.empty() && directory.count(name);
 }
 
+struct chunk_job
+{
+    chunk_reader *in;
+    vector<unsigned char> *data;
+    string error;
+    bool corrupt;
+};
+
+static void* _inflate_chunk(void *arg)
+{
+#define SPACE 32768
+    chunk_job *job = (chunk_job*)arg;
+    try
+    {
+        plen_t s, at;
+        do
+        {
+            at = job->data->size();
+            job->data->resize(at + SPACE);
+            s = job->in->read(&(*job->data)[at], SPACE);
+        } while (s == SPACE);
+        job->data->resize(at + s);
+    }
+    catch (corrupted_save &err)
+    {
+        job->error = err.msg;
+        job->corrupt = true;
+    }
+    catch (ext_fail_exception &err)
+    {
+        job->error = err.msg;
+    }
+    return 0;
+#undef SPACE
+}
+
+// Read several chunks in full, decompressing them concurrently.  Only the
+// block reads themselves are serialized; inflating is where the time goes.
+void package::read_chunks(const vector<string> &names,
+                          vector<vector<unsigned char> > &data)
+{
+    const size_t n = names.size();
+    data.clear();
+    data.resize(n);
+
+    vector<chunk_job> jobs(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        jobs[i].in = new chunk_reader(this, names[i]);
+        jobs[i].data = &data[i];
+        jobs[i].corrupt = false;
+    }
+
+    vector<thread_t> th(n);
+    for (size_t i = 0; i < n; i++)
+#ifndef DGAMELAUNCH
+        if (n < 2 || thread_create_joinable(&th[i], _inflate_chunk, &jobs[i]))
+#endif
+        {
+            // if thread creation fails, do it serially
+            th[i] = 0;
+            _inflate_chunk(&jobs[i]);
+        }
+    for (size_t i = 0; i < n; i++)
+        if (th[i])
+            thread_join(th[i]);
+
+    for (size_t i = 0; i < n; i++)
+        delete jobs[i].in;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (jobs[i].corrupt)
+            corrupted("%s", jobs[i].error.c_str());
+        else if (!jobs[i].error.empty())
+            fail("%s", jobs[i].error.c_str());
+    }
+}
+
 vector<string> package::list_chunks()
 {
     vector<string> list;
@@ -859,6 +972,19 @@ chunk_reader::~chunk_reader()
     pkg->n_users--;
 }
 
+void chunk_reader::next_block_header()
+{
+    block_header bl;
+    pkg->read_raw(next_block, &bl, sizeof(block_header));
+
+    off = next_block + sizeof(block_header);
+    block_left = htole(bl.len);
+    next_block = htole(bl.next);
+    // This reeks of on-disk corruption (zeroed data).
+    if (!block_left)
+        corrupted("save file corrupted -- empty block");
+}
+
 plen_t chunk_reader::raw_read(void *data, plen_t len)
 {
     void *buf = data;
@@ -868,33 +994,13 @@ plen_t chunk_reader::raw_read(void *data, plen_t len)
         {
             if (!next_block)
                 return (char*)buf - (char*)data;
-
-            block_header bl;
-            pkg->seek(next_block);
-            ssize_t res = ::read(pkg->fd, &bl, sizeof(block_header));
-            if (res < 0)
-                sysfail("error reading the save file");
-            if (res != sizeof(block_header))
-                corrupted("save file corrupted -- block past eof");
-
-            off = next_block + sizeof(block_header);
-            block_left = htole(bl.len);
-            next_block = htole(bl.next);
-            // This reeks of on-disk corruption (zeroed data).
-            if (!block_left)
-                corrupted("save file corrupted -- empty block");
+            next_block_header();
         }
-        else
-            pkg->seek(off);
 
         plen_t s = len;
         if (s > block_left)
             s = block_left;
-        ssize_t res = ::read(pkg->fd, buf, s);
-        if (res < 0)
-            sysfail("error reading the save file");
-        if ((plen_t)res != s)
-            corrupted("save file corrupted -- block past eof");
+        pkg->read_raw(off, buf, s);
 
         buf = (char*)buf + s;
         off += s;
@@ -921,7 +1027,30 @@ plen_t chunk_reader::read(void *data, plen_t len)
     zs.avail_out = len;
     while (zs.avail_out)
     {
-        if (!zs.avail_in)
+        if (!zs.avail_in && !pkg->rw)
+        {
+            // Read-only packages (mostly the save browser) read each block
+            // of the chunk whole, with a single read(), and inflate it from
+            // there, instead of staging it through z_buffer piece by piece.
+            if (!block_left)
+            {
+                if (!next_block)
+                    corrupted("save file corrupted -- block truncated");
+                next_block_header();
+            }
+            Bytef *in = z_buffer;
+            if (block_left > sizeof(z_buffer))
+            {
+                block_buf.resize(block_left);
+                in = &block_buf[0];
+            }
+            pkg->read_raw(off, in, block_left);
+            zs.next_in  = in;
+            zs.avail_in = block_left;
+            off += block_left;
+            block_left = 0;
+        }
+        else if (!zs.avail_in)
         {
             zs.next_in  = z_buffer;
             zs.avail_in = raw_read(z_buffer, sizeof(z_buffer));
@@ -50,8 +50,10 @@ private:
     bool eof;
     z_stream zs;
     Bytef z_buffer[32768];
+    vector<Bytef> block_buf;
 #endif
     plen_t raw_read(void *data, plen_t len);
+    void next_block_header();
 public:
     chunk_reader(package *parent, const string _name);
     ~chunk_reader();
@@ -72,6 +74,8 @@ public:
     void delete_chunk(const string name);
     bool has_chunk(const string name);
     vector<string> list_chunks();
+    void read_chunks(const vector<string> &names,
+                     vector<vector<unsigned char> > &data);
     void abort();
     void unlink();
 
@@ -104,6 +108,7 @@ private:
     void free_block_chain(plen_t at);
     void free_block(plen_t at, plen_t size);
     void seek(plen_t to);
+    void read_raw(plen_t at, void *data, plen_t len);
     void fsck();
     void read_directory(plen_t start, uint8_t version);
     void trace_chunk(plen_t start);
@@ -15,33 +15,63 @@
 
 #include "pattern.h"
 
+#include "libutil.h"
+
 #if defined(REGEX_PCRE)
 ////////////////////////////////////////////////////////////////////
 // Perl Compatible Regular Expressions
 
+#ifdef PCRE_STUDY_JIT_COMPILE
+# define STUDY_FLAGS PCRE_STUDY_JIT_COMPILE
+#else
+# define STUDY_FLAGS 0
+# define pcre_free_study pcre_free
+#endif
+
+struct pcre_pattern
+{
+    pcre *re;
+    pcre_extra *extra;
+};
+
 static void *_compile_pattern(const char *pattern, bool icase)
 {
     const char *error;
     int erroffset;
     int flags = icase ? PCRE_CASELESS : 0;
-    return pcre_compile(pattern,
-                        flags,
-                        &error,
-                        &erroffset,
-                        NULL);
+    pcre *re = pcre_compile(pattern,
+                            flags,
+                            &error,
+                            &erroffset,
+                            NULL);
+    if (!re)
+        return NULL;
+
+    // Patterns are shared and long-lived, so studying them pays off.
+    pcre_pattern *pp = new pcre_pattern;
+    pp->re = re;
+    pp->extra = pcre_study(re, STUDY_FLAGS, &error);
+    return pp;
 }
 
 static void _free_compiled_pattern(void *cp)
 {
     if (cp)
-        pcre_free(cp);
+    {
+        pcre_pattern *pp = static_cast<pcre_pattern *>(cp);
+        if (pp->extra)
+            pcre_free_study(pp->extra);
+        pcre_free(pp->re);
+        delete pp;
+    }
 }
 
 static bool _pattern_match(void *compiled_pattern, const char *text, int length)
 {
+    const pcre_pattern *pp = static_cast<pcre_pattern *>(compiled_pattern);
     int ovector[42];
-    int pcre_rc = pcre_exec(static_cast<pcre *>(compiled_pattern),
-                            NULL,
+    int pcre_rc = pcre_exec(pp->re,
+                            pp->extra,
                             text, length, 0, 0,
                             ovector, sizeof(ovector) / sizeof(*ovector));
     return pcre_rc >= 0;
@@ -90,10 +120,78 @@ static bool _pattern_match(void *compiled_pattern, const char *text, int length)
 ////////////////////////////////////////////////////////////////////
 #endif
 
+////////////////////////////////////////////////////////////////////
+// Pool of compiled patterns
+
+typedef pair<string, bool> pattern_key;
+
+struct pooled_pattern
+{
+    pattern_key key;
+    void *compiled;
+    int refs;
+};
+
+// Function-local so that it outlives any static text_pattern.
+static map<pattern_key, pooled_pattern *> &_pattern_pool()
+{
+    static map<pattern_key, pooled_pattern *> *pool =
+        new map<pattern_key, pooled_pattern *>;
+    return *pool;
+}
+
+unsigned int text_pattern::compiles = 0;
+unsigned int text_pattern::cache_hits = 0;
+
+static pooled_pattern *_acquire_pattern(const string &pattern, bool icase)
+{
+    const pattern_key key(pattern, icase);
+    map<pattern_key, pooled_pattern *> &pool = _pattern_pool();
+    map<pattern_key, pooled_pattern *>::iterator i = pool.find(key);
+    if (i != pool.end())
+    {
+        text_pattern::cache_hits++;
+        i->second->refs++;
+        return i->second;
+    }
+
+    text_pattern::compiles++;
+    void *compiled = _compile_pattern(pattern.c_str(), icase);
+    if (!compiled)
+        return NULL;
+
+    pooled_pattern *pp = new pooled_pattern;
+    pp->key = key;
+    pp->compiled = compiled;
+    pp->refs = 1;
+    pool[key] = pp;
+    return pp;
+}
+
+void *text_pattern::share(void *cp)
+{
+    if (cp)
+    {
+        cache_hits++;
+        static_cast<pooled_pattern *>(cp)->refs++;
+    }
+    return cp;
+}
+
+void text_pattern::release(void *cp)
+{
+    pooled_pattern *pp = static_cast<pooled_pattern *>(cp);
+    if (!pp || --pp->refs)
+        return;
+
+    _pattern_pool().erase(pp->key);
+    _free_compiled_pattern(pp->compiled);
+    delete pp;
+}
+
 text_pattern::~text_pattern()
 {
-    if (compiled_pattern)
-        _free_compiled_pattern(compiled_pattern);
+    release(compiled_pattern);
 }
 
 const text_pattern &text_pattern::operator= (const text_pattern &tp)
@@ -101,12 +199,12 @@ const text_pattern &text_pattern::operator= (const text_pattern &tp)
     if (this == &tp)
         return tp;
 
-    if (compiled_pattern)
-        _free_compiled_pattern(compiled_pattern);
+    void *old = compiled_pattern;
     pattern = tp.pattern;
-    compiled_pattern = NULL;
+    compiled_pattern = share(tp.compiled_pattern);
     isvalid      = tp.isvalid;
     ignore_case  = tp.ignore_case;
+    release(old);
     return *this;
 }
 
@@ -115,8 +213,7 @@ const text_pattern &text_pattern::operator= (const string &spattern)
     if (pattern == spattern)
         return *this;
 
-    if (compiled_pattern)
-        _free_compiled_pattern(compiled_pattern);
+    release(compiled_pattern);
     pattern = spattern;
     compiled_pattern = NULL;
     isvalid = true;
@@ -135,11 +232,280 @@ bool text_pattern::operator== (const text_pattern &tp) const
 bool text_pattern::compile() const
 {
     return !empty()?
-        !!(compiled_pattern = _compile_pattern(pattern.c_str(), ignore_case))
+        !!(compiled_pattern = _acquire_pattern(pattern, ignore_case))
       : false;
 }
 
 bool text_pattern::matches(const char *s, int length) const
 {
-    return valid() && _pattern_match(compiled_pattern, s, length);
+    return valid()
+           && _pattern_match(static_cast<pooled_pattern *>(compiled_pattern)
+                                 ->compiled, s, length);
+}
+
+////////////////////////////////////////////////////////////////////
+// pattern_set
+
+static bool _is_regex_special(char c)
+{
+    return strchr("\\^$.|?*+()[]{}", c);
+}
+
+static bool _is_case_safe(const text_pattern &pat, unsigned char c)
+{
+    // Case folding of non-ASCII text depends on the regex library and the
+    // locale, so don't try to second-guess it.
+    return !pat.ignores_case() || c < 128;
+}
+
+// Only ASCII is folded, byte by byte, to line up with _is_case_safe().
+static string _fold_ascii(string s)
+{
+    for (unsigned int i = 0; i < s.length(); ++i)
+        s[i] = tolower((unsigned char)s[i]);
+    return s;
+}
+
+// Returns true if the pattern matches nothing but its own text.
+static bool _is_plain_text(const text_pattern &pat)
+{
+    const string &p = pat.tostring();
+    for (unsigned int i = 0; i < p.length(); ++i)
+        if (_is_regex_special(p[i]) || !_is_case_safe(pat, p[i]))
+            return false;
+    return !p.empty();
+}
+
+// Finds the longest piece of text that every match of the pattern has to
+// contain.  Anything not understood gives up and returns "".
+static string _required_literal(const text_pattern &pat)
+{
+    const string &p = pat.tostring();
+    if (p.find('|') != string::npos)
+        return "";
+
+    string best, run;
+    int depth = 0;
+    for (unsigned int i = 0; i < p.length(); ++i)
+    {
+        const char c = p[i];
+        if (c == '\\')
+        {
+            // Only an escaped metacharacter stands for itself: \d, \1 and
+            // friends aren't the text they look like, and GNU regex takes
+            // \< \> \` \' as anchors.
+            if (i + 1 >= p.length() || !_is_regex_special(p[i + 1]))
+                return "";
+            const char e = p[++i];
+            if (depth)
+                continue;
+            if (_is_case_safe(pat, e))
+            {
+                run += e;
+                continue;
+            }
+        }
+        else if (c == '[')
+        {
+            // Skip the whole bracket expression, which may itself start
+            // with ']' or contain [:class:] items.
+            unsigned int j = i + 1;
+            if (j < p.length() && p[j] == '^')
+                ++j;
+            if (j < p.length() && p[j] == ']')
+                ++j;
+            for (; j < p.length() && p[j] != ']'; ++j)
+            {
+#ifdef REGEX_PCRE
+                // PCRE, unlike POSIX, allows escapes such as \] in a class.
+                if (p[j] == '\\')
+                {
+                    ++j;
+                    continue;
+                }
+#endif
+                if (p[j] == '[' && j + 1 < p.length()
+                    && strchr(":.=", p[j + 1]))
+                {
+                    const string::size_type end =
+                        p.find(string(1, p[j + 1]) + "]", j + 2);
+                    if (end == string::npos)
+                        return "";
+                    j = end + 1;
+                }
+            }
+            if (j >= p.length())
+                return "";
+            i = j;
+        }
+        else if (c == '(')
+            ++depth;
+        else if (c == ')')
+            --depth;
+        else if (depth)
+            continue;
+        else if (c == '?' || c == '*' || c == '{')
+        {
+            // The preceding character is optional.
+            if (!run.empty())
+                run.erase(run.length() - 1);
+            if (c == '{')
+            {
+                const string::size_type end = p.find('}', i);
+                if (end == string::npos)
+                    return "";
+                i = end;
+            }
+        }
+        else if (!_is_regex_special(c) && _is_case_safe(pat, c))
+        {
+            run += c;
+            continue;
+        }
+
+        if (run.length() > best.length())
+            best = run;
+        run.clear();
+    }
+    if (run.length() > best.length())
+        best = run;
+
+    return _fold_ascii(best);
+}
+
+string text_pattern::required_literal() const
+{
+    return _is_plain_text(*this) ? _fold_ascii(pattern)
+                                 : _required_literal(*this);
+}
+
+void pattern_set::clear()
+{
+    patterns.clear();
+    literals.clear();
+    plain.clear();
+    unfiltered.clear();
+    nodes.clear();
+    built = false;
+}
+
+int pattern_set::add(const text_pattern &pat)
+{
+    const int id = patterns.size();
+    patterns.push_back(pat);
+
+    const string lit = pat.required_literal();
+    plain.push_back(_is_plain_text(pat));
+    if (lit.empty() && !pat.empty())
+        unfiltered.push_back(id);
+    literals.push_back(lit);
+
+    built = false;
+    return id;
+}
+
+void pattern_set::build() const
+{
+    nodes.clear();
+    nodes.push_back(node());
+    nodes[0].fail = 0;
+
+    // Trie of all the literals...
+    for (unsigned int id = 0; id < literals.size(); ++id)
+    {
+        const string &lit = literals[id];
+        if (lit.empty())
+            continue;
+
+        int cur = 0;
+        for (unsigned int i = 0; i < lit.length(); ++i)
+        {
+            const unsigned char c = lit[i];
+            map<unsigned char, int>::const_iterator nx = nodes[cur].next.find(c);
+            if (nx == nodes[cur].next.end())
+            {
+                nodes[cur].next[c] = nodes.size();
+                cur = nodes.size();
+                nodes.push_back(node());
+            }
+            else
+                cur = nx->second;
+        }
+        nodes[cur].out.push_back(id);
+    }
+
+    // ... then failure links, breadth first so that a node's fail target
+    // is complete by the time the node itself is visited.
+    vector<int> queue;
+    for (map<unsigned char, int>::const_iterator i = nodes[0].next.begin();
+         i != nodes[0].next.end(); ++i)
+    {
+        nodes[i->second].fail = 0;
+        queue.push_back(i->second);
+    }
+    for (unsigned int q = 0; q < queue.size(); ++q)
+    {
+        const int cur = queue[q];
+        for (map<unsigned char, int>::const_iterator i = nodes[cur].next.begin();
+             i != nodes[cur].next.end(); ++i)
+        {
+            int f = nodes[cur].fail;
+            while (f && !nodes[f].next.count(i->first))
+                f = nodes[f].fail;
+            map<unsigned char, int>::const_iterator nx =
+                nodes[f].next.find(i->first);
+            const int fail = nx != nodes[f].next.end() ? nx->second : 0;
+
+            nodes[i->second].fail = fail;
+            nodes[i->second].out.insert(nodes[i->second].out.end(),
+                                        nodes[fail].out.begin(),
+                                        nodes[fail].out.end());
+            queue.push_back(i->second);
+        }
+    }
+
+    built = true;
+}
+
+void pattern_set::match(const string &s, vector<bool> &matched) const
+{
+    matched.assign(patterns.size(), false);
+    if (patterns.empty())
+        return;
+
+    if (!built)
+        build();
+
+    vector<bool> candidate(patterns.size(), false);
+    int cur = 0;
+    for (unsigned int i = 0; i < s.length(); ++i)
+    {
+        const unsigned char c = tolower((unsigned char)s[i]);
+        map<unsigned char, int>::const_iterator nx;
+        while ((nx = nodes[cur].next.find(c)) == nodes[cur].next.end() && cur)
+            cur = nodes[cur].fail;
+        cur = nx != nodes[cur].next.end() ? nx->second : 0;
+
+        const vector<int> &out = nodes[cur].out;
+        for (unsigned int j = 0; j < out.size(); ++j)
+        {
+            const int id = out[j];
+            if (!plain[id])
+                candidate[id] = true;
+            else if (!matched[id])
+            {
+                const string &text = patterns[id].tostring();
+                matched[id] = patterns[id].ignores_case()
+                              || !s.compare(i + 1 - text.length(),
+                                            text.length(), text);
+            }
+        }
+    }
+
+    for (unsigned int i = 0; i < unfiltered.size(); ++i)
+        candidate[unfiltered[i]] = true;
+
+    for (unsigned int id = 0; id < patterns.size(); ++id)
+        if (candidate[id])
+            matched[id] = patterns[id].matches(s);
 }
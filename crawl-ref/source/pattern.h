@@ -26,10 +26,11 @@ public:
     {
     }
 
+    // Copies share the original's compiled regex, if it has one.
     text_pattern(const text_pattern &tp)
         : base_pattern(tp),
           pattern(tp.pattern),
-          compiled_pattern(NULL),
+          compiled_pattern(share(tp.compiled_pattern)),
           isvalid(tp.isvalid),
           ignore_case(tp.ignore_case)
     {
@@ -66,10 +67,64 @@ public:
         return pattern;
     }
 
+    bool ignores_case() const { return ignore_case; }
+
+    // Text that every match has to contain, with ASCII lowercased, or ""
+    // if there is no such text or the pattern is too clever to tell.
+    string required_literal() const;
+
+    // Compiled regexes are pooled by (pattern, ignore_case) and shared
+    // between all text_patterns that use them.  These count the regexes
+    // actually compiled, and the compiles saved by the pool.
+    static unsigned int compiles;
+    static unsigned int cache_hits;
+
 private:
+    static void *share(void *cp);
+    static void release(void *cp);
+
     string pattern;
     mutable void *compiled_pattern;
     mutable bool isvalid;
     bool ignore_case;
 };
+
+// Matches a string against a whole list of text_patterns in one pass.
+//
+// Every pattern contributes a literal that any match must contain: the whole
+// pattern if it has no regex syntax, otherwise the longest run of plain
+// text outside groups and alternations, if there is one.  A single
+// Aho-Corasick scan over the string finds all of these literals.  Plain
+// text patterns are decided by that scan alone; other patterns only get
+// their regex run if their literal was seen, or if they have none.
+class pattern_set
+{
+public:
+    pattern_set() : built(false) { }
+
+    void clear();
+    // Returns the index of the new pattern.
+    int add(const text_pattern &pat);
+    int size() const { return patterns.size(); }
+
+    // Sets matched[i] for each pattern i that matches s.
+    void match(const string &s, vector<bool> &matched) const;
+
+private:
+    struct node
+    {
+        map<unsigned char, int> next;
+        int fail;
+        vector<int> out;            // patterns whose literal ends here
+    };
+
+    void build() const;
+
+    vector<text_pattern> patterns;
+    vector<string> literals;        // lowercased; empty if none
+    vector<bool> plain;             // the literal is the whole pattern
+    vector<int> unfiltered;         // regexes with no literal to look for
+    mutable vector<node> nodes;
+    mutable bool built;
+};
 #endif
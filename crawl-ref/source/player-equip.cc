@@ -64,6 +64,7 @@ void equip_item(equipment_type slot, int item_slot, bool msg)
     // Maybe this prevent a carried item from allowing training.
     maybe_change_train(you.inv[item_slot], false);
     you.equip[slot] = item_slot;
+    you.invalidate_stat_cache();
     item_skills(you.inv[item_slot], you.start_train);
 
     _equip_effect(slot, item_slot, false, msg);
@@ -85,6 +86,7 @@ bool unequip_item(equipment_type slot, bool msg)
     {
         item_skills(you.inv[item_slot], you.stop_train);
         you.equip[slot] = -1;
+        you.invalidate_stat_cache();
         // Maybe this allows training for a carried item.
         maybe_change_train(you.inv[item_slot], true);
 
@@ -106,6 +108,7 @@ bool meld_slot(equipment_type slot, bool msg)
     if (you.equip[slot] != -1 && !you.melded[slot])
     {
         you.melded.set(slot);
+        you.invalidate_stat_cache();
         _unequip_effect(slot, you.equip[slot], true, msg);
         return true;
     }
@@ -120,6 +123,7 @@ bool unmeld_slot(equipment_type slot, bool msg)
     if (you.equip[slot] != -1 && you.melded[slot])
     {
         you.melded.set(slot, false);
+        you.invalidate_stat_cache();
         _equip_effect(slot, you.equip[slot], true, msg);
         return true;
     }
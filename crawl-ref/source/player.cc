@@ -1533,7 +1533,7 @@ int player_likes_chunks(bool permanently)
 }
 
 // If temp is set to false, temporary sources or resistance won't be counted.
-int player_res_fire(bool calc_unid, bool temp, bool items)
+static int _res_fire(bool calc_unid, bool temp, bool items)
 {
     if (you.species == SP_DJINNI)
         return 4; // full immunity
@@ -1639,7 +1639,7 @@ int player_res_fire(bool calc_unid, bool temp, bool items)
     return rf;
 }
 
-int player_res_steam(bool calc_unid, bool temp, bool items)
+static int _res_steam(bool calc_unid, bool temp, bool items)
 {
     int res = 0;
     const int rf = player_res_fire(calc_unid, temp, items);
@@ -1666,7 +1666,7 @@ int player_res_steam(bool calc_unid, bool temp, bool items)
     return res;
 }
 
-int player_res_cold(bool calc_unid, bool temp, bool items)
+static int _res_cold(bool calc_unid, bool temp, bool items)
 {
     int rc = 0;
 
@@ -1801,7 +1801,7 @@ bool player::res_corr(bool calc_unid, bool items) const
     return actor::res_corr(calc_unid, items);
 }
 
-int player_res_acid(bool calc_unid, bool items)
+static int _res_acid(bool calc_unid, bool, bool items)
 {
     if (you.form == TRAN_JELLY || you.form == TRAN_WISP)
         return 3;
@@ -1821,7 +1821,7 @@ int player_acid_resist_factor()
     return 100;
 }
 
-int player_res_electricity(bool calc_unid, bool temp, bool items)
+static int _res_electricity(bool calc_unid, bool temp, bool items)
 {
     int re = 0;
 
@@ -1898,7 +1898,7 @@ int player_kiku_res_torment()
 }
 
 // If temp is set to false, temporary sources or resistance won't be counted.
-int player_res_poison(bool calc_unid, bool temp, bool items)
+static int _res_poison(bool calc_unid, bool temp, bool items)
 {
     if ((you.is_undead == US_SEMI_UNDEAD ? you.hunger_state == HS_STARVING
             : you.is_undead && (temp || you.form != TRAN_LICH))
@@ -2009,7 +2009,7 @@ static int _maybe_reduce_poison(int amount)
     return new_amount;
 }
 
-int player_res_sticky_flame(bool calc_unid, bool temp, bool items)
+static int _res_sticky_flame(bool calc_unid, bool temp, bool items)
 {
     int rsf = 0;
 
@@ -2038,7 +2038,7 @@ int player_res_sticky_flame(bool calc_unid, bool temp, bool items)
     return rsf;
 }
 
-int player_spec_death()
+static int _spec_death()
 {
     int sd = 0;
 
@@ -2065,7 +2065,7 @@ int player_spec_death()
     return sd;
 }
 
-int player_spec_fire()
+static int _spec_fire()
 {
     int sf = 0;
 
@@ -2088,7 +2088,7 @@ int player_spec_fire()
     return sf;
 }
 
-int player_spec_cold()
+static int _spec_cold()
 {
     int sc = 0;
 
@@ -2112,7 +2112,7 @@ int player_spec_cold()
     return sc;
 }
 
-int player_spec_earth()
+static int _spec_earth()
 {
     int se = 0;
 
@@ -2126,7 +2126,7 @@ int player_spec_earth()
     return se;
 }
 
-int player_spec_air()
+static int _spec_air()
 {
     int sa = 0;
 
@@ -2140,7 +2140,7 @@ int player_spec_air()
     return sa;
 }
 
-int player_spec_conj()
+static int _spec_conj()
 {
     int sc = 0;
 
@@ -2154,7 +2154,7 @@ int player_spec_conj()
     return sc;
 }
 
-int player_spec_hex()
+static int _spec_hex()
 {
     int sh = 0;
 
@@ -2175,7 +2175,7 @@ int player_spec_charm()
     return 0;
 }
 
-int player_spec_summ()
+static int _spec_summ()
 {
     int ss = 0;
 
@@ -2189,7 +2189,7 @@ int player_spec_summ()
     return ss;
 }
 
-int player_spec_poison()
+static int _spec_poison()
 {
     int sp = 0;
 
@@ -2222,7 +2222,7 @@ int player_energy()
 
 // If temp is set to false, temporary sources of resistance won't be
 // counted.
-int player_prot_life(bool calc_unid, bool temp, bool items)
+static int _prot_life(bool calc_unid, bool temp, bool items)
 {
     int pl = 0;
 
@@ -2315,6 +2315,192 @@ int player_prot_life(bool calc_unid, bool temp, bool items)
     return pl;
 }
 
+void player::invalidate_stat_cache()
+{
+    stat_cache.filled = false;
+}
+
+static void _stat_cache_stamp(player_stat_cache::stamp_type &st)
+{
+    static const duration_type durs[] =
+    {
+        DUR_RESISTANCE, DUR_FIRE_SHIELD, DUR_FIRE_VULN, DUR_DIVINE_STAMINA,
+        DUR_PETRIFIED,
+    };
+
+    memset(&st, 0, sizeof(st));
+    for (unsigned int i = 0; i < ARRAYSZ(durs); ++i)
+        if (you.duration[durs[i]])
+            st.durations |= 1 << i;
+    st.piety            = you.piety;
+    st.temperature      = you.species == SP_LAVA_ORC ? temperature() : 0;
+    st.species          = you.species;
+    st.religion         = you.religion;
+    st.hunger_state     = you.hunger_state;
+    st.experience_level = you.experience_level;
+    st.suppressed       = you.suppressed();
+    st.divine_lightning = !!you.attribute[ATTR_DIVINE_LIGHTNING_PROTECTION];
+}
+
+// Returns false if the cache can't be used at the moment.
+static bool _stat_cache_ready()
+{
+    player_stat_cache &cache = you.stat_cache;
+
+    player_stat_cache::stamp_type now;
+    _stat_cache_stamp(now);
+
+    if (!cache.filled)
+    {
+        // The dragonskin cloak's share of the draconic resistances is
+        // decided by a coin flip on every call.
+        cache.uncacheable = player_equip_unrand(UNRAND_DRAGONSKIN);
+        cache.filled = true;
+    }
+    else if (!memcmp(&now, &cache.stamp, sizeof(now)))
+        return !cache.uncacheable;
+
+    cache.stamp = now;
+    memset(cache.known, 0, sizeof(cache.known));
+    return !cache.uncacheable;
+}
+
+static int _cached_stat(player_cached_stat which,
+                        int (*calc)(bool calc_unid, bool temp, bool items),
+                        bool calc_unid, bool temp, bool items)
+{
+    if (!calc_unid || !_stat_cache_ready())
+        return calc(calc_unid, temp, items);
+
+    player_stat_cache &cache = you.stat_cache;
+    const int variant = temp * 2 + items;
+    if (cache.known[which] & (1 << variant))
+    {
+        const int val = cache.value[which][variant];
+#ifdef DEBUG_STAT_CACHE
+        const int fresh = calc(calc_unid, temp, items);
+        ASSERTM(val == fresh, "stale cached player stat %d: %d, should be %d",
+                which, val, fresh);
+#endif
+        return val;
+    }
+
+    const int val = calc(calc_unid, temp, items);
+    cache.value[which][variant] = val;
+    cache.known[which] |= 1 << variant;
+    return val;
+}
+
+static int _cached_stat(player_cached_stat which, int (*calc)())
+{
+    if (!_stat_cache_ready())
+        return calc();
+
+    player_stat_cache &cache = you.stat_cache;
+    if (cache.known[which])
+    {
+        const int val = cache.value[which][0];
+#ifdef DEBUG_STAT_CACHE
+        const int fresh = calc();
+        ASSERTM(val == fresh, "stale cached player stat %d: %d, should be %d",
+                which, val, fresh);
+#endif
+        return val;
+    }
+
+    const int val = calc();
+    cache.value[which][0] = val;
+    cache.known[which] = 1;
+    return val;
+}
+
+int player_res_fire(bool calc_unid, bool temp, bool items)
+{
+    return _cached_stat(PCS_RES_FIRE, _res_fire, calc_unid, temp, items);
+}
+
+int player_res_steam(bool calc_unid, bool temp, bool items)
+{
+    return _cached_stat(PCS_RES_STEAM, _res_steam, calc_unid, temp, items);
+}
+
+int player_res_cold(bool calc_unid, bool temp, bool items)
+{
+    return _cached_stat(PCS_RES_COLD, _res_cold, calc_unid, temp, items);
+}
+
+int player_res_acid(bool calc_unid, bool items)
+{
+    return _cached_stat(PCS_RES_ACID, _res_acid, calc_unid, true, items);
+}
+
+int player_res_electricity(bool calc_unid, bool temp, bool items)
+{
+    return _cached_stat(PCS_RES_ELEC, _res_electricity, calc_unid, temp,
+                        items);
+}
+
+int player_res_poison(bool calc_unid, bool temp, bool items)
+{
+    return _cached_stat(PCS_RES_POISON, _res_poison, calc_unid, temp, items);
+}
+
+int player_res_sticky_flame(bool calc_unid, bool temp, bool items)
+{
+    return _cached_stat(PCS_RES_STICKY_FLAME, _res_sticky_flame, calc_unid,
+                        temp, items);
+}
+
+int player_prot_life(bool calc_unid, bool temp, bool items)
+{
+    return _cached_stat(PCS_PROT_LIFE, _prot_life, calc_unid, temp, items);
+}
+
+int player_spec_death()
+{
+    return _cached_stat(PCS_SPEC_DEATH, _spec_death);
+}
+
+int player_spec_fire()
+{
+    return _cached_stat(PCS_SPEC_FIRE, _spec_fire);
+}
+
+int player_spec_cold()
+{
+    return _cached_stat(PCS_SPEC_COLD, _spec_cold);
+}
+
+int player_spec_earth()
+{
+    return _cached_stat(PCS_SPEC_EARTH, _spec_earth);
+}
+
+int player_spec_air()
+{
+    return _cached_stat(PCS_SPEC_AIR, _spec_air);
+}
+
+int player_spec_conj()
+{
+    return _cached_stat(PCS_SPEC_CONJ, _spec_conj);
+}
+
+int player_spec_hex()
+{
+    return _cached_stat(PCS_SPEC_HEX, _spec_hex);
+}
+
+int player_spec_summ()
+{
+    return _cached_stat(PCS_SPEC_SUMM, _spec_summ);
+}
+
+int player_spec_poison()
+{
+    return _cached_stat(PCS_SPEC_POISON, _spec_poison);
+}
+
 // New player movement speed system... allows for a bit more than
 // "player runs fast" and "player walks slow" in that the speed is
 // actually calculated (allowing for centaurs to get a bonus from
@@ -6063,6 +6249,8 @@ void player::init()
     redraw_evasion      = false;
     redraw_title        = false;
 
+    stat_cache.filled   = false;
+
     flash_colour        = BLACK;
     flash_where         = nullptr;
 
@@ -27,6 +27,60 @@ class targetter;
 int check_stealth(void);
 
 typedef FixedVector<int, NUM_DURATIONS> durations_t;
+
+enum player_cached_stat
+{
+    PCS_RES_FIRE,
+    PCS_RES_STEAM,
+    PCS_RES_COLD,
+    PCS_RES_ACID,
+    PCS_RES_ELEC,
+    PCS_RES_POISON,
+    PCS_RES_STICKY_FLAME,
+    PCS_PROT_LIFE,
+    PCS_SPEC_DEATH,
+    PCS_SPEC_FIRE,
+    PCS_SPEC_COLD,
+    PCS_SPEC_EARTH,
+    PCS_SPEC_AIR,
+    PCS_SPEC_CONJ,
+    PCS_SPEC_HEX,
+    PCS_SPEC_SUMM,
+    PCS_SPEC_POISON,
+    NUM_PLAYER_CACHED_STATS
+};
+
+// Resistances and spell enhancers, as worked out by player_res_fire() and
+// friends.  Only the calc_unid versions are kept.
+//
+// Equipment, mutations and form only change through a handful of
+// functions, which call player::invalidate_stat_cache().  Everything else
+// the results depend on is cheap to look at but written to from all over
+// the place, so it is copied into the stamp and compared on each lookup.
+struct player_stat_cache
+{
+    struct stamp_type
+    {
+        uint32_t durations;      // which of the relevant durations are on
+        int      piety;
+        int      temperature;
+        uint8_t  species;
+        uint8_t  religion;
+        uint8_t  hunger_state;
+        uint8_t  experience_level;
+        uint8_t  suppressed;
+        uint8_t  divine_lightning;
+    };
+
+    bool       filled;
+    bool       uncacheable;      // wearing something that rolls dice
+    stamp_type stamp;
+    // Bit (temp * 2 + items) of known[s] is set once value[s][temp * 2 +
+    // items] has been worked out.
+    uint8_t    known[NUM_PLAYER_CACHED_STATS];
+    int8_t     value[NUM_PLAYER_CACHED_STATS][4];
+};
+
 class player : public actor
 {
 public:
@@ -343,6 +397,9 @@ public:
   bool redraw_armour_class;
   bool redraw_evasion;
 
+  // Cached resistances and spell enhancers.
+  player_stat_cache stat_cache;
+
   colour_t flash_colour;
   targetter *flash_where;
 
@@ -739,6 +796,9 @@ public:
     void del_gold(int delta);
     void set_gold(int amount);
 
+    // Must be called whenever equipment, mutations or form change.
+    void invalidate_stat_cache();
+
     void increase_duration(duration_type dur, int turns, int cap = 0,
                            const char* msg = NULL);
     void set_duration(duration_type dur, int turns, int cap = 0,
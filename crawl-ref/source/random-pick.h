@@ -6,6 +6,9 @@
 #ifndef RANDOMPICK_H
 #define RANDOMPICK_H
 
+#include <map>
+#include <vector>
+
 #include "random.h"
 
 enum distrib_type
@@ -28,6 +31,38 @@ struct random_pick_entry
     T value;
 };
 
+// A fixed set of weighted values, set up as an alias table (Vose's method)
+// so that a roll costs two random numbers however many values there are.
+template <typename T>
+class random_pick_table
+{
+public:
+    random_pick_table() : total(0) { }
+
+    void add(T value, int weight);
+    void build();
+
+    bool empty() const { return values.empty(); }
+    int size() const { return values.size(); }
+    T value(int i) const { return values[i]; }
+    int weight(int i) const { return weights[i]; }
+
+    T pick() const;
+    template <typename V> T pick(V &vetoer, T none) const;
+
+private:
+    vector<T> values;
+    vector<int> weights;
+    vector<int> cut;
+    vector<int> alias;
+    int total;
+};
+
+// Rolls against a vetoing picker start by rerolling vetoed values, which
+// leaves the odds of the others untouched; pickers that veto most of the
+// table give up after this many tries and roll over the survivors instead.
+#define RANDOM_PICK_TRIES 4
+
 template <typename T, int max>
 class random_picker
 {
@@ -37,8 +72,100 @@ public:
     int rarity_at(const random_pick_entry<T> *pop,
                   int depth);
     virtual bool veto(T val) { return false; }
+
+    bool operator()(T val) { return veto(val); }
+
+private:
+    const random_pick_table<T> &table_for(const random_pick_entry<T> *weights,
+                                          int level);
 };
 
+template <typename T>
+void random_pick_table<T>::add(T value, int weight)
+{
+    values.push_back(value);
+    weights.push_back(weight);
+    total += weight;
+}
+
+template <typename T>
+void random_pick_table<T>::build()
+{
+    // Every value gets a column of height total; a column is filled first by
+    // its own value (up to cut) and topped up by its alias.  Scaling the
+    // weights by n keeps all of this in exact integers.
+    const int n = values.size();
+    cut.assign(n, total);
+    alias.resize(n);
+    vector<int64_t> scaled(n);
+    vector<int> small, large;
+    for (int i = 0; i < n; ++i)
+    {
+        alias[i] = i;
+        scaled[i] = (int64_t)weights[i] * n;
+        if (scaled[i] < total)
+            small.push_back(i);
+        else
+            large.push_back(i);
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        const int s = small.back(), l = large.back();
+        small.pop_back();
+        cut[s] = scaled[s];
+        alias[s] = l;
+        scaled[l] -= total - scaled[s];
+        if (scaled[l] < total)
+        {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+}
+
+template <typename T>
+T random_pick_table<T>::pick() const
+{
+    const int i = random2(values.size());
+    return random2(total) < cut[i] ? values[i] : values[alias[i]];
+}
+
+template <typename T>
+template <typename V>
+T random_pick_table<T>::pick(V &vetoer, T none) const
+{
+    if (values.empty())
+        return none;
+
+    for (int tries = 0; tries < RANDOM_PICK_TRIES; ++tries)
+    {
+        const T val = pick();
+        if (!vetoer(val))
+            return val;
+    }
+
+    vector<bool> vetoed(values.size());
+    int totalrar = 0;
+    for (int i = 0; i < size(); i++)
+    {
+        vetoed[i] = vetoer(values[i]);
+        if (!vetoed[i])
+            totalrar += weights[i];
+    }
+
+    if (!totalrar)
+        return none;
+
+    totalrar = random2(totalrar); // the roll!
+
+    for (int i = 0; i < size(); i++)
+        if (!vetoed[i] && (totalrar -= weights[i]) < 0)
+            return values[i];
+
+    die("random_pick roll out of range");
+}
+
 template <typename T, int max>
 random_picker<T, max>::~random_picker()
 {
@@ -48,37 +175,39 @@ template <typename T, int max>
 T random_picker<T, max>::pick(const random_pick_entry<T> *weights, int level,
                               T none)
 {
-    struct { T value; int rarity; } valid[max];
-    int nvalid = 0;
-    int totalrar = 0;
+    return table_for(weights, level).pick(*this, none);
+}
+
+// Tables are built on first use and kept for good, keyed on the address of
+// the weights; those must therefore be static data.
+template <typename T, int max>
+const random_pick_table<T> &
+random_picker<T, max>::table_for(const random_pick_entry<T> *weights,
+                                 int level)
+{
+    static map<pair<const random_pick_entry<T> *, int>,
+               random_pick_table<T> > tables;
 
+    const pair<const random_pick_entry<T> *, int> key(weights, level);
+    typename map<pair<const random_pick_entry<T> *, int>,
+                 random_pick_table<T> >::iterator it = tables.find(key);
+    if (it != tables.end())
+        return it->second;
+
+    random_pick_table<T> &table = tables[key];
     for (const random_pick_entry<T> *pop = weights; pop->rarity; pop++)
     {
         if (level < pop->minr || level > pop->maxr)
             continue;
 
-        if (veto(pop->value))
-            continue;
-
         int rar = rarity_at(pop, level);
         ASSERTM(rar > 0, "Rarity %d: %d at level %d", rar, pop->value, level);
+        ASSERT(table.size() < max);
 
-        valid[nvalid].value = pop->value;
-        valid[nvalid].rarity = rar;
-        totalrar += rar;
-        nvalid++;
+        table.add(pop->value, rar);
     }
-
-    if (!nvalid)
-        return none;
-
-    totalrar = random2(totalrar); // the roll!
-
-    for (int i = 0; i < nvalid; i++)
-        if ((totalrar -= valid[i].rarity) < 0)
-            return valid[i].value;
-
-    die("random_pick roll out of range");
+    table.build();
+    return table;
 }
 
 template <typename T, int max>
@@ -45,7 +45,10 @@
 
 extern int stealth;             // defined in main.cc
 
-static noise_grid _noise_grid;
+// Noises are registered on one grid while the other propagates, since
+// monsters woken by a noise may let out yips of their own.
+static noise_grid _noise_grids[2];
+static noise_grid *_noise_grid = &_noise_grids[0];
 static void _actor_apply_noise(actor *act,
                                const coord_def &apparent_source,
                                int noise_intensity_millis,
@@ -463,17 +466,28 @@ void noisy_equipment()
 
 void apply_noises()
 {
-    // [ds] This copying isn't awesome, but we cannot otherwise handle
-    // the case where one set of noises wakes up monsters who then let
-    // out yips of their own, modifying _noise_grid while it is in the
-    // middle of propagate_noise().
-    if (_noise_grid.dirty())
+    static bool propagating = false;
+
+    if (!_noise_grid->dirty())
+        return;
+
+    // Both grids are spoken for if this is called from within
+    // propagate_noise(), so fall back to a copy.
+    if (propagating)
     {
-        noise_grid copy = _noise_grid;
-        // Reset the main grid.
-        _noise_grid.reset();
+        noise_grid copy = *_noise_grid;
+        _noise_grid->reset();
         copy.propagate_noise();
+        return;
     }
+
+    noise_grid &grid(*_noise_grid);
+    _noise_grid = &_noise_grids[_noise_grid == &_noise_grids[0]];
+    _noise_grid->reset();
+
+    propagating = true;
+    grid.propagate_noise();
+    propagating = false;
 }
 
 // noisy() has a messaging service for giving messages to the player
@@ -512,7 +526,7 @@ bool noisy(int original_loudness, const coord_def& where,
     // Add +1 to scaled_loudness so that all squares adjacent to a
     // sound of loudness 1 will hear the sound.
     const string noise_msg(msg? msg : "");
-    _noise_grid.register_noise(
+    _noise_grid->register_noise(
         noise_t(where,
                 noise_msg,
                 (scaled_loudness + 1) * 1000,
@@ -733,9 +747,8 @@ void blood_smell(int strength, const coord_def& where)
 
 // Currently noise attenuation depends solely on the feature in question.
 // Permarock walls are assumed to completely kill noise.
-static int _noise_attenuation_millis(const coord_def &pos)
+static int _feat_noise_attenuation_millis(dungeon_feature_type feat)
 {
-    const dungeon_feature_type feat = grd(pos);
     switch (feat)
     {
     // Closed doors are excellent at cutting off sound.
@@ -757,9 +770,27 @@ static int _noise_attenuation_millis(const coord_def &pos)
     }
 }
 
+static int _noise_attenuation_millis(const coord_def &pos)
+{
+    // By feature rather than by cell, so terrain changes need no care.
+    static int attenuation[NUM_FEATURES];
+    static bool filled = false;
+    if (!filled)
+    {
+        for (int f = 0; f < NUM_FEATURES; ++f)
+        {
+            attenuation[f] =
+                _feat_noise_attenuation_millis((dungeon_feature_type)f);
+        }
+        filled = true;
+    }
+
+    return attenuation[grd(pos)];
+}
+
 noise_cell::noise_cell()
     : neighbour_delta(0, 0), noise_id(-1), noise_intensity_millis(0),
-      noise_travel_distance(0)
+      noise_travel_distance(0), generation(0)
 {
 }
 
@@ -802,29 +833,52 @@ int noise_cell::turn_angle(const coord_def &next_delta) const
 }
 
 noise_grid::noise_grid()
-    : cells(), noises(), affected_actor_count(0)
+    : cells(), generation(1), noises(), affected_actor_count(0)
 {
 }
 
 void noise_grid::reset()
 {
-    cells.init(noise_cell());
+    // Moving on to a new generation silences every cell at once.
+    if (!++generation)
+    {
+        cells.init(noise_cell());
+        generation = 1;
+    }
     noises.clear();
     affected_actor_count = 0;
 }
 
+noise_cell &noise_grid::cell_at(const coord_def &pos)
+{
+    noise_cell &c(cells(pos));
+    if (c.generation != generation)
+    {
+        c = noise_cell();
+        c.generation = generation;
+    }
+    return c;
+}
+
+const noise_cell &noise_grid::cell_at(const coord_def &pos) const
+{
+    static const noise_cell quiet;
+    const noise_cell &c(cells(pos));
+    return c.generation == generation ? c : quiet;
+}
+
 void noise_grid::register_noise(const noise_t &noise)
 {
-    noise_cell &target_cell(cells(noise.noise_source));
+    noise_cell &target_cell(cell_at(noise.noise_source));
     if (target_cell.can_apply_noise(noise.noise_intensity_millis))
     {
         const int noise_index = noises.size();
         noises.push_back(noise);
         noises[noise_index].noise_id = noise_index;
-        cells(noise.noise_source).apply_noise(noise.noise_intensity_millis,
-                                              noise_index,
-                                              0,
-                                              coord_def(0, 0));
+        target_cell.apply_noise(noise.noise_intensity_millis,
+                                noise_index,
+                                0,
+                                coord_def(0, 0));
     }
 }
 
@@ -836,33 +890,37 @@ void noise_grid::propagate_noise()
 #ifdef DEBUG_NOISE_PROPAGATION
     dprf("noise_grid: %u noises to apply", (unsigned int)noises.size());
 #endif
-    vector<coord_def> noise_perimeter[2];
     int circ_index = 0;
+    perimeter[0].clear();
+    perimeter[1].clear();
 
     for (int i = 0, size = noises.size(); i < size; ++i)
-        noise_perimeter[circ_index].push_back(noises[i].noise_source);
+        perimeter[circ_index].push_back(noises[i].noise_source);
+
+    // Skip the silence checks entirely on the usual silence-free level.
+    const bool check_silence = any_silence();
 
     int travel_distance = 0;
-    while (!noise_perimeter[circ_index].empty())
+    while (!perimeter[circ_index].empty())
     {
-        const vector<coord_def> &perimeter(noise_perimeter[circ_index]);
-        vector<coord_def> &next_perimeter(noise_perimeter[!circ_index]);
+        const vector<coord_def> &current(perimeter[circ_index]);
+        vector<coord_def> &next_perimeter(perimeter[!circ_index]);
         ++travel_distance;
-        for (int i = 0, size = perimeter.size(); i < size; ++i)
+        for (int i = 0, size = current.size(); i < size; ++i)
         {
-            const coord_def p(perimeter[i]);
-            const noise_cell &cell(cells(p));
+            const coord_def p(current[i]);
+            const noise_cell &c(cell_at(p));
 
-            if (!cell.silent())
+            if (!c.silent())
             {
                 apply_noise_effects(p,
-                                    cell.noise_intensity_millis,
-                                    noises[cell.noise_id],
+                                    c.noise_intensity_millis,
+                                    noises[c.noise_id],
                                     travel_distance - 1);
 
                 const int attenuation = _noise_attenuation_millis(p);
                 // If the base noise attenuation kills the noise, go no farther:
-                if (noise_is_audible(cell.noise_intensity_millis - attenuation))
+                if (noise_is_audible(c.noise_intensity_millis - attenuation))
                 {
                     // [ds] Not using adjacent iterator which has
                     // unnecessary overhead for the tight loop here.
@@ -875,12 +933,13 @@ void noise_grid::propagate_noise()
                                 const coord_def next_position(p.x + xi,
                                                               p.y + yi);
                                 if (in_bounds(next_position)
-                                    && !silenced(next_position))
+                                    && !(check_silence
+                                         && silenced(next_position)))
                                 {
                                     if (propagate_noise_to_neighbour(
                                             attenuation,
                                             travel_distance,
-                                            cell, p,
+                                            c, p,
                                             next_position))
                                     {
                                         next_perimeter.push_back(next_position);
@@ -893,7 +952,7 @@ void noise_grid::propagate_noise()
             }
         }
 
-        noise_perimeter[circ_index].clear();
+        perimeter[circ_index].clear();
         circ_index = !circ_index;
     }
 
@@ -913,7 +972,7 @@ bool noise_grid::propagate_noise_to_neighbour(int base_attenuation,
                                               const coord_def &current_pos,
                                               const coord_def &next_pos)
 {
-    noise_cell &neighbour(cells(next_pos));
+    noise_cell &neighbour(cell_at(next_pos));
     if (!neighbour.can_apply_noise(cell.noise_intensity_millis
                                    - base_attenuation))
     {
@@ -1001,7 +1060,8 @@ coord_def noise_grid::noise_perceived_position(actor *act,
                                                const coord_def &affected_pos,
                                                const noise_t &noise) const
 {
-    const int noise_travel_distance = cells(affected_pos).noise_travel_distance;
+    const int noise_travel_distance =
+        cell_at(affected_pos).noise_travel_distance;
     if (!noise_travel_distance)
         return noise.noise_source;
 
@@ -1114,7 +1174,7 @@ static void _write_noise_grid_css(FILE *outf)
 
 void noise_grid::write_cell(FILE *outf, coord_def p, int ch) const
 {
-    const int intensity = min(25, cells(p).noise_intensity_millis / 1000);
+    const int intensity = min(25, cell_at(p).noise_intensity_millis / 1000);
     if (intensity)
         fprintf(outf,
                 "<span class='i%d'>&#%d;</span>",
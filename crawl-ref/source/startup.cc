@@ -145,6 +145,13 @@ static void _initialize()
     if (crawl_state.build_db)
         end(0);
 
+    if (!crawl_state.savebench.empty())
+    {
+        release_cli_signals();
+        savebench(crawl_state.savebench);
+        // doesn't return
+    }
+
 #ifdef USE_TILE_LOCAL
     if (!Options.tile_skip_title && crawl_state.title_screen)
     {
@@ -18,6 +18,7 @@
 #include "itemprop.h"
 #include "godpassive.h"
 #include "godprayer.h"
+#include "hash.h"
 #include "invent.h"
 #include "items.h"
 #include "kills.h"
@@ -27,6 +28,7 @@
 #include "message.h"
 #include "mon-util.h"
 #include "notes.h"
+#include "options.h"
 #include "place.h"
 #include "religion.h"
 #include "shopping.h"
@@ -169,7 +171,7 @@ static void _fully_identify_item(item_def *item)
 // Stash
 // ----------------------------------------------------------------------
 
-Stash::Stash(int xp, int yp) : enabled(true), items()
+Stash::Stash(int xp, int yp) : enabled(true), items(), search_valid(false)
 {
     // First, fix what square we're interested in
     if (xp == -1)
@@ -581,6 +583,77 @@ string Stash::feature_description() const
     return feat_desc;
 }
 
+// Everything an item's search text depends on, other than the options.
+static uint32_t _search_stamp(const item_def &item)
+{
+    const int32_t state[] =
+    {
+        item.base_type, item.sub_type, item.plus, item.plus2, item.special,
+        item.quantity, item.rnd, item.orig_monnum, (int32_t)item.flags,
+        item_type_has_ids(item.base_type)
+            ? you.type_ids[item.base_type][item.sub_type] : 0,
+    };
+    return hash32(state, sizeof(state)) * 31
+           + hash32(item.inscription.data(), item.inscription.length());
+}
+
+// Trigrams are three bytes of text, lowercased the way
+// text_pattern::required_literal() does it.
+static void _add_trigrams(const string &text, vector<uint32_t> &trigrams)
+{
+    for (unsigned int i = 2; i < text.length(); ++i)
+    {
+        trigrams.push_back(tolower((unsigned char)text[i - 2]) << 16
+                           | tolower((unsigned char)text[i - 1]) << 8
+                           | tolower((unsigned char)text[i]));
+    }
+}
+
+bool Stash::refresh_search_text(vector<uint32_t> &old_trigrams) const
+{
+    vector<uint32_t> stamps(items.size());
+    for (unsigned int i = 0; i < items.size(); ++i)
+        stamps[i] = _search_stamp(items[i]);
+
+    if (search_valid && stamps == search_stamps && feat_desc == search_feat)
+        return false;
+
+    search_valid = true;
+    search_stamps.swap(stamps);
+    search_feat = feat_desc;
+    search_names.resize(items.size());
+    search_annotations.resize(items.size());
+    search_descs.resize(items.size());
+    old_trigrams.swap(search_trigrams);
+    search_trigrams.clear();
+
+    for (unsigned int i = 0; i < items.size(); ++i)
+    {
+        const item_def &item = items[i];
+        search_names[i] = stash_item_name(item);
+        search_annotations[i] =
+            stash_annotate_item(STASH_LUA_SEARCH_ANNOTATE, &item);
+        _add_trigrams(search_annotations[i] + search_names[i],
+                      search_trigrams);
+
+        if (is_dumpable_artefact(item, false))
+        {
+            search_descs[i] =
+                munge_description(get_item_description(item, false, true));
+            _add_trigrams(search_descs[i], search_trigrams);
+        }
+        else
+            search_descs[i].clear();
+    }
+    _add_trigrams(feat_desc, search_trigrams);
+
+    sort(search_trigrams.begin(), search_trigrams.end());
+    search_trigrams.erase(unique(search_trigrams.begin(),
+                                 search_trigrams.end()),
+                          search_trigrams.end());
+    return true;
+}
+
 bool Stash::matches_search(const string &prefix,
                            const base_pattern &search,
                            stash_search_result &res) const
@@ -588,33 +661,19 @@ bool Stash::matches_search(const string &prefix,
     if (!enabled || items.empty() && feat == DNGN_FLOOR)
         return false;
 
+    ASSERT(search_valid && search_names.size() == items.size());
     for (unsigned i = 0; i < items.size(); ++i)
     {
         const item_def &item = items[i];
+        const string &s = search_names[i];
 
-        const string s   = stash_item_name(item);
-        const string ann = stash_annotate_item(STASH_LUA_SEARCH_ANNOTATE, &item);
-        if (search.matches(prefix + " " + ann + s))
+        if (search.matches(prefix + " " + search_annotations[i] + s)
+            || !search_descs[i].empty() && search.matches(search_descs[i]))
         {
             if (!res.count++)
                 res.match = s;
             res.matches += item.quantity;
             res.matching_items.push_back(item);
-            continue;
-        }
-
-        if (is_dumpable_artefact(item, false))
-        {
-            const string desc =
-                munge_description(get_item_description(item, false, true));
-
-            if (search.matches(desc))
-            {
-                if (!res.count++)
-                    res.match = s;
-                res.matches += item.quantity;
-                res.matching_items.push_back(item);
-            }
         }
     }
 
@@ -1120,7 +1179,9 @@ void ShopInfo::load(reader& inf)
 LevelStashes::LevelStashes()
     : m_place(level_id::current()),
       m_stashes(),
-      m_shops()
+      m_shops(),
+      m_search_index(),
+      m_search_generation(Options.generation)
 {
 }
 
@@ -1228,6 +1289,8 @@ void LevelStashes::move_stash(const coord_def& from, const coord_def& to)
     int old_abs = s->abs_pos();
     s->x = to.x;
     s->y = to.y;
+    _unindex_stash(old_abs, s->trigrams());
+    s->invalidate_search_text();
     m_stashes.insert(pair<int, Stash>(s->abs_pos(), *s));
     m_stashes.erase(old_abs);
 }
@@ -1235,6 +1298,7 @@ void LevelStashes::move_stash(const coord_def& from, const coord_def& to)
 // Removes a Stash from the level.
 void LevelStashes::kill_stash(const Stash &s)
 {
+    _unindex_stash(s.abs_pos(), s.trigrams());
     m_stashes.erase(s.abs_pos());
 }
 
@@ -1318,18 +1382,108 @@ void LevelStashes::_waypoint_search(
     const Stash* stash = find_stash(waypoint.pos);
     if (!stash)
         return;
+    _refresh_search_index(*stash);
     stash_search_result res;
     stash->matches_search("", text_pattern(".*"), res);
     res.pos.id = m_place;
     results.push_back(res);
 }
 
+void LevelStashes::_unindex_stash(int abspos,
+                                  const vector<uint32_t> &trigrams) const
+{
+    for (unsigned int i = 0; i < trigrams.size(); ++i)
+    {
+        search_index_t::iterator it = m_search_index.find(trigrams[i]);
+        if (it == m_search_index.end())
+            continue;
+        it->second.erase(abspos);
+        if (it->second.empty())
+            m_search_index.erase(it);
+    }
+}
+
+void LevelStashes::_refresh_search_index(const Stash &s) const
+{
+    vector<uint32_t> old_trigrams;
+    if (!s.refresh_search_text(old_trigrams))
+        return;
+
+    _unindex_stash(s.abs_pos(), old_trigrams);
+    const vector<uint32_t> &trigrams = s.trigrams();
+    for (unsigned int i = 0; i < trigrams.size(); ++i)
+        m_search_index[trigrams[i]].insert(s.abs_pos());
+}
+
+// Finds the stashes whose search text has every trigram of the literal,
+// in abspos order.
+void LevelStashes::_search_candidates(const string &literal,
+                                      vector<int> &abspos) const
+{
+    vector<uint32_t> trigrams;
+    _add_trigrams(literal, trigrams);
+
+    vector<const set<int> *> postings;
+    for (unsigned int i = 0; i < trigrams.size(); ++i)
+    {
+        search_index_t::const_iterator it = m_search_index.find(trigrams[i]);
+        if (it == m_search_index.end())
+            return;
+        postings.push_back(&it->second);
+    }
+
+    // Start from the rarest trigram and whittle it down.
+    unsigned int rarest = 0;
+    for (unsigned int i = 1; i < postings.size(); ++i)
+        if (postings[i]->size() < postings[rarest]->size())
+            rarest = i;
+
+    for (set<int>::const_iterator it = postings[rarest]->begin();
+         it != postings[rarest]->end(); ++it)
+    {
+        bool found = true;
+        for (unsigned int i = 0; i < postings.size() && found; ++i)
+            found = postings[i]->count(*it);
+        if (found)
+            abspos.push_back(*it);
+    }
+}
+
+// Could a match for the literal lie partly or wholly in the level name
+// that's prefixed to each item's search text?
+static bool _literal_overlaps_prefix(const string &prefix,
+                                     const string &literal)
+{
+    string p = prefix + " ";
+    for (unsigned int i = 0; i < p.length(); ++i)
+        p[i] = tolower((unsigned char)p[i]);
+    if (p.find(literal) != string::npos)
+        return true;
+    for (unsigned int k = 1; k < literal.length() && k <= p.length(); ++k)
+        if (!p.compare(p.length() - k, k, literal, 0, k))
+            return true;
+    return false;
+}
+
 void LevelStashes::get_matching_stashes(
         const base_pattern &search,
+        const string &literal,
         vector<stash_search_result> &results) const
 {
     string lplace = "{" + m_place.describe() + "}";
 
+    if (m_search_generation != Options.generation)
+    {
+        // Item names and annotations may depend on the options.
+        m_search_index.clear();
+        for (stashes_t::const_iterator iter = m_stashes.begin();
+             iter != m_stashes.end(); ++iter)
+        {
+            iter->second.invalidate_search_text();
+        }
+        m_search_generation = Options.generation;
+    }
+
     // a single digit or * means we're searching for waypoints' content.
     const string s = search.tostring();
     if (s == "*")
@@ -1344,10 +1498,33 @@ void LevelStashes::get_matching_stashes(
         return;
     }
 
+    // Bring the index up to date; this only regenerates the text of
+    // stashes whose items have changed since the last search.
     for (stashes_t::const_iterator iter = m_stashes.begin();
             iter != m_stashes.end(); ++iter)
     {
         if (iter->second.enabled)
+            _refresh_search_index(iter->second);
+    }
+
+    vector<int> candidates;
+    const bool use_index = literal.length() >= 3
+                           && !_literal_overlaps_prefix(lplace, literal);
+    if (use_index)
+        _search_candidates(literal, candidates);
+    else
+    {
+        for (stashes_t::const_iterator iter = m_stashes.begin();
+                iter != m_stashes.end(); ++iter)
+        {
+            candidates.push_back(iter->first);
+        }
+    }
+
+    for (unsigned int i = 0; i < candidates.size(); ++i)
+    {
+        stashes_t::const_iterator iter = m_stashes.find(candidates[i]);
+        if (iter != m_stashes.end() && iter->second.enabled)
         {
             stash_search_result res;
             if (iter->second.matches_search(lplace, search, res))
@@ -1438,6 +1615,7 @@ void LevelStashes::load(reader& inf)
     m_place.load(inf);
 
     m_stashes.clear();
+    m_search_index.clear();
     for (int i = 0; i < size; ++i)
     {
         Stash s;
@@ -1792,7 +1970,8 @@ void StashTracker::search_stashes()
         return ;
     }
 
-    get_matching_stashes(*search, results, curr_lev);
+    const string literal = search == &tpat ? tpat.required_literal() : "";
+    get_matching_stashes(*search, literal, results, curr_lev);
 
     if (results.empty())
     {
@@ -1827,6 +2006,7 @@ void StashTracker::search_stashes()
 
 void StashTracker::get_matching_stashes(
         const base_pattern &search,
+        const string &literal,
         vector<stash_search_result> &results,
         bool curr_lev)
     const
@@ -1837,7 +2017,7 @@ void StashTracker::get_matching_stashes(
     {
         if (curr_lev && curr != iter->first)
             continue;
-        iter->second.get_matching_stashes(search, results);
+        iter->second.get_matching_stashes(search, literal, results);
         if (results.size() > SEARCH_SPAM_THRESHOLD)
             return;
     }
@@ -10,6 +10,7 @@
 #include <string>
 
 #include <map>
+#include <set>
 #include <vector>
 
 #include "externs.h"
@@ -55,11 +56,19 @@ public:
     // verify the stash).
     bool unverified() const;
 
+    // Only looks at the search text cached by refresh_search_text().
     bool matches_search(const string &prefix,
                         const base_pattern &search,
                         stash_search_result &res)
             const;
 
+    // Rebuilds the cached search text if any item (or the feature) has
+    // changed since it was last built, handing back the trigrams it used
+    // to have.  Returns false if nothing needed doing.
+    bool refresh_search_text(vector<uint32_t> &old_trigrams) const;
+    void invalidate_search_text() const { search_valid = false; }
+    const vector<uint32_t> &trigrams() const { return search_trigrams; }
+
     void write(FILE *f, int refx = 0, int refy = 0,
                  string place = "",
                  bool identify = false) const;
@@ -96,6 +105,15 @@ private:
 
     vector<item_def> items;
 
+    // Search text for each item, and the item stamps it was built from.
+    mutable bool search_valid;
+    mutable vector<uint32_t> search_stamps;
+    mutable vector<string> search_names;
+    mutable vector<string> search_annotations;
+    mutable vector<string> search_descs;     // "" unless an artefact
+    mutable string search_feat;
+    mutable vector<uint32_t> search_trigrams; // sorted, ASCII-lowercased
+
     static bool are_items_same(const item_def &, const item_def &);
 
     friend class LevelStashes;
@@ -236,7 +254,10 @@ public:
 
     level_id where() const;
 
+    // If literal isn't empty, every match of search must contain it; this
+    // lets the search index skip stashes that can't match.
     void get_matching_stashes(const base_pattern &search,
+                              const string &literal,
                               vector<stash_search_result> &results) const;
 
     // Update stash at (x,y) on current level, defaulting to player's current
@@ -285,16 +306,24 @@ public:
     void _update_corpses(int rot_time);
     void _update_identification();
     void _waypoint_search(int n, vector<stash_search_result> &results) const;
+    void _refresh_search_index(const Stash &s) const;
+    void _unindex_stash(int abspos, const vector<uint32_t> &trigrams) const;
+    void _search_candidates(const string &literal, vector<int> &abspos) const;
 
  private:
     typedef map<int, Stash>  stashes_t;
     typedef vector<ShopInfo> shops_t;
+    // Trigram to the stashes (by abspos) that have it in their search text.
+    typedef map<uint32_t, set<int> > search_index_t;
 
     // which level
     level_id m_place;
     stashes_t m_stashes;
     shops_t m_shops;
 
+    mutable search_index_t m_search_index;
+    mutable unsigned m_search_generation;   // Options.generation it's for
+
     friend class StashTracker;
     friend class ST_ItemIterator;
 };
@@ -348,6 +377,7 @@ public:
     void remove_shop(const level_pos &pos);
 private:
     void get_matching_stashes(const base_pattern &search,
+                              const string &literal,
                               vector<stash_search_result> &results,
                               bool curr_lev = false) const;
     bool display_search_results(vector<stash_search_result> &results,
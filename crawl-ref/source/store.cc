@@ -12,10 +12,13 @@
 #include "externs.h"
 #include "libutil.h"
 #include "monster.h"
+#include "stuff.h"
 #include "tags.h"
 #include "travel.h"
 
 #include <algorithm>
+#include <deque>
+#include <new>
 
 // These tend to be called from tight loops, and C++ method calls don't
 // get optimized away except for LTO -fwhole-program builds, so merely
@@ -1235,51 +1238,264 @@ string &CrawlStoreValue::operator += (const string &_val)
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 
+//////////////////////////////
+// Interned key names
+
+// Names are never forgotten: there are only as many as the code and the
+// vaults use.  A deque, so that references to names stay valid.  These are
+// function statics since global tables may be filled in at startup.
+static deque<string> &_key_names()
+{
+    static deque<string> names(1);     // id 0 is no key
+    return names;
+}
+
+static vector<uint32_t> &_key_index()  // open-addressed, holds ids
+{
+    static vector<uint32_t> index;
+    return index;
+}
+
+static uint32_t _name_hash(const char *s, size_t len)
+{
+    uint32_t h = 2166136261U;
+    for (size_t i = 0; i < len; ++i)
+    {
+        h ^= (unsigned char)s[i];
+        h *= 16777619U;
+    }
+    return h;
+}
+
+// Returns the id of the name, or 0 if it has never been interned.
+static uint32_t _find_key(const char *name, size_t len, uint32_t hash)
+{
+    const deque<string> &key_names = _key_names();
+    const vector<uint32_t> &key_index = _key_index();
+    if (key_index.empty())
+        return 0;
+
+    const uint32_t mask = key_index.size() - 1;
+    for (uint32_t i = hash & mask; key_index[i]; i = (i + 1) & mask)
+    {
+        const string &k = key_names[key_index[i]];
+        if (k.length() == len && !memcmp(k.data(), name, len))
+            return key_index[i];
+    }
+    return 0;
+}
+
+static uint32_t _intern_key(const char *name, size_t len)
+{
+    const uint32_t hash = _name_hash(name, len);
+    if (uint32_t id = _find_key(name, len, hash))
+        return id;
+
+    deque<string> &key_names = _key_names();
+    vector<uint32_t> &key_index = _key_index();
+
+    // Keep the index at most half full.
+    if (key_names.size() * 2 >= key_index.size())
+    {
+        vector<uint32_t> old(max<size_t>(64, key_index.size() * 2), 0);
+        old.swap(key_index);
+        const uint32_t mask = key_index.size() - 1;
+        for (unsigned int i = 0; i < old.size(); ++i)
+        {
+            if (!old[i])
+                continue;
+            const string &k = key_names[old[i]];
+            uint32_t j = _name_hash(k.data(), k.length()) & mask;
+            while (key_index[j])
+                j = (j + 1) & mask;
+            key_index[j] = old[i];
+        }
+    }
+
+    const uint32_t id = key_names.size();
+    key_names.push_back(string(name, len));
+
+    const uint32_t mask = key_index.size() - 1;
+    uint32_t j = hash & mask;
+    while (key_index[j])
+        j = (j + 1) & mask;
+    key_index[j] = id;
+    return id;
+}
+
+static uint32_t _find_key(const char *name, size_t len)
+{
+    return _find_key(name, len, _name_hash(name, len));
+}
+
+const string &CrawlHashTable::key_type::name() const
+{
+    return _key_names()[id];
+}
+
+unsigned int CrawlHashTable::interned_keys()
+{
+    return _key_names().size() - 1;
+}
+
+// Spreads the (sequential) key ids over the table.
+static inline uint32_t _slot_hash(uint32_t key)
+{
+    key *= 2654435761U;
+    return key ^ (key >> 16);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 CrawlHashTable::CrawlHashTable()
+    : heap(NULL), capacity(HASH_INLINE_SLOTS), count(0)
 {
-    hash_map = NULL;
+    for (int i = 0; i < HASH_INLINE_SLOTS; ++i)
+        slots()[i].first.id = 0;
 }
 
 CrawlHashTable::CrawlHashTable(const CrawlHashTable& other)
+    : heap(NULL), capacity(HASH_INLINE_SLOTS), count(0)
 {
-    if (other.hash_map == NULL)
+    for (int i = 0; i < HASH_INLINE_SLOTS; ++i)
+        slots()[i].first.id = 0;
+    copy_from(other);
+}
+
+CrawlHashTable::~CrawlHashTable()
+{
+    clear();
+}
+
+CrawlHashTable &CrawlHashTable::operator = (const CrawlHashTable &other)
+{
+    if (this != &other)
     {
-        hash_map = NULL;
+        clear();
+        copy_from(other);
+    }
+    return *this;
+}
+
+// Copies other's entries into this table, which must be empty and inline.
+void CrawlHashTable::copy_from(const CrawlHashTable &other)
+{
+    if (!other.count)
         return;
+
+    // The same capacity keeps every entry in the same slot.
+    if (other.heap)
+    {
+        heap = static_cast<entry *>(malloc(other.capacity * sizeof(entry)));
+        if (!heap)
+            ::end(1, false, "out of memory copying a hash table");
+        capacity = other.capacity;
     }
 
-    hash_map = new hash_map_type(*(other.hash_map));
+    entry *dst = slots();
+    const entry *src = other.slots();
+    for (uint32_t i = 0; i < capacity; ++i)
+    {
+        dst[i].first = src[i].first;
+        if (src[i].first.id)
+            new (&dst[i].second) CrawlStoreValue(src[i].second);
+    }
+    count = other.count;
 }
 
-CrawlHashTable::~CrawlHashTable()
+uint32_t CrawlHashTable::find_slot(uint32_t key) const
 {
-    // NOTE: Not using unique_ptr because making hash_map an unique_ptr
-    // causes compile weirdness in externs.h
-    if (hash_map == NULL)
-        return;
+    if (!key || !count)
+        return capacity;
 
-    delete hash_map;
-    hash_map = NULL;
+    const entry *e = slots();
+    const uint32_t mask = capacity - 1;
+    uint32_t i = _slot_hash(key) & mask;
+    for (uint32_t n = 0; n < capacity && e[i].first.id; ++n, i = (i + 1) & mask)
+        if (e[i].first.id == key)
+            return i;
+    return capacity;
 }
 
-CrawlHashTable &CrawlHashTable::operator = (const CrawlHashTable &other)
+// Moves everything to a heap table twice the size.
+void CrawlHashTable::grow()
 {
-    if (hash_map != NULL)
-        delete hash_map;
+    const uint32_t new_capacity = max<uint32_t>(8, capacity * 2);
+    entry *fresh = static_cast<entry *>(malloc(new_capacity * sizeof(entry)));
+    if (!fresh)
+        ::end(1, false, "out of memory growing a hash table");
+    for (uint32_t i = 0; i < new_capacity; ++i)
+        fresh[i].first.id = 0;
 
-    if (other.hash_map == NULL)
+    // Values don't point into themselves, so they can just be moved
+    // bytewise without copying what they own.
+    const uint32_t mask = new_capacity - 1;
+    entry *old = slots();
+    for (uint32_t i = 0; i < capacity; ++i)
     {
-        hash_map = NULL;
-        return *this;
+        if (!old[i].first.id)
+            continue;
+        uint32_t j = _slot_hash(old[i].first.id) & mask;
+        while (fresh[j].first.id)
+            j = (j + 1) & mask;
+        memcpy(static_cast<void *>(&fresh[j]), &old[i], sizeof(entry));
     }
 
-    hash_map = new hash_map_type(*(other.hash_map));
+    free(heap);
+    heap = fresh;
+    capacity = new_capacity;
+}
+
+CrawlStoreValue &CrawlHashTable::insert(uint32_t key)
+{
+    // Inline tables may fill up, heap ones are kept under 3/4 full.
+    if (heap ? (count + 1) * 4 > capacity * 3 : count == capacity)
+        grow();
+
+    entry *e = slots();
+    const uint32_t mask = capacity - 1;
+    uint32_t i = _slot_hash(key) & mask;
+    while (e[i].first.id)
+        i = (i + 1) & mask;
 
-    return *this;
+    e[i].first.id = key;
+    new (&e[i].second) CrawlStoreValue();
+    ++count;
+    return e[i].second;
+}
+
+void CrawlHashTable::erase_slot(uint32_t slot)
+{
+    entry *e = slots();
+    e[slot].second.~CrawlStoreValue();
+    e[slot].first.id = 0;
+    --count;
+
+    // Shift later entries of the probe run back into the hole, so that
+    // lookups never need to look past an empty slot.
+    const uint32_t mask = capacity - 1;
+    uint32_t hole = slot;
+    for (uint32_t n = 1, j = (slot + 1) & mask; n < capacity && e[j].first.id;
+         ++n, j = (j + 1) & mask)
+    {
+        const uint32_t home = _slot_hash(e[j].first.id) & mask;
+        if (((j - home) & mask) >= ((j - hole) & mask))
+        {
+            memcpy(static_cast<void *>(&e[hole]), &e[j], sizeof(entry));
+            e[j].first.id = 0;
+            hole = j;
+        }
+    }
 }
 
 //////////////////////////////
 // Read/write from/to savefile
+static bool _entry_name_less(const CrawlHashTable::entry *a,
+                             const CrawlHashTable::entry *b)
+{
+    return a->first.name() < b->first.name();
+}
+
 void CrawlHashTable::write(writer &th) const
 {
     ASSERT_VALIDITY();
@@ -1291,12 +1507,19 @@ void CrawlHashTable::write(writer &th) const
 
     marshallUnsigned(th, size());
 
-    CrawlHashTable::hash_map_type::const_iterator i = hash_map->begin();
+    // Slot order depends on the order keys were interned in, so write the
+    // entries sorted by name; that keeps saves reproducible, and matches
+    // what older versions wrote.
+    vector<const entry*> sorted;
+    sorted.reserve(size());
+    for (const_iterator i = begin(); i != end(); ++i)
+        sorted.push_back(&*i);
+    sort(sorted.begin(), sorted.end(), _entry_name_less);
 
-    for (; i != hash_map->end(); ++i)
+    for (size_t i = 0; i < sorted.size(); ++i)
     {
-        marshallString(th, i->first);
-        i->second.write(th);
+        marshallString(th, sorted[i]->first);
+        sorted[i]->second.write(th);
     }
 
     ASSERT_VALIDITY();
@@ -1318,11 +1541,6 @@ void CrawlHashTable::read(reader &th)
     unsigned int _size = unmarshallUnsigned(th);
 #endif
 
-    if (_size == 0)
-        return;
-
-    init_hash_map();
-
     for (unsigned int i = 0; i < _size; i++)
     {
         string           key = unmarshallString(th);
@@ -1347,32 +1565,38 @@ static map<string, int> accesses;
 
 bool CrawlHashTable::exists(const string &key) const
 {
-    if (hash_map == NULL)
+    if (!count)
         return false;
 
     ACCESS(key);
     ASSERT_VALIDITY();
-    hash_map_type::const_iterator i = hash_map->find(key);
+    return find_slot(_find_key(key.data(), key.length())) != capacity;
+}
 
-    return i != hash_map->end();
+bool CrawlHashTable::exists(const char *key) const
+{
+    if (!count)
+        return false;
+
+    ACCESS(key);
+    ASSERT_VALIDITY();
+    return find_slot(_find_key(key, strlen(key))) != capacity;
 }
 
 void CrawlHashTable::assert_validity() const
 {
 #ifdef DEBUG
-    if (hash_map == NULL)
-        return;
-
-    hash_map_type::const_iterator i = hash_map->begin();
-
     size_t actual_size = 0;
 
-    for (; i != hash_map->end(); ++i)
+    const entry *e = slots();
+    for (uint32_t i = 0; i < capacity; ++i)
     {
+        if (!e[i].first.id)
+            continue;
         actual_size++;
 
-        const string          &key = i->first;
-        const CrawlStoreValue &val = i->second;
+        const string          &key = e[i].first;
+        const CrawlStoreValue &val = e[i].second;
 
         ASSERT(!key.empty());
         string trimmed = trimmed_string(key);
@@ -1428,128 +1652,134 @@ void CrawlHashTable::assert_validity() const
 CrawlStoreValue& CrawlHashTable::get_value(const string &key)
 {
     ASSERT_VALIDITY();
-    init_hash_map();
 
     ACCESS(key);
-    iterator i = hash_map->find(key);
+    const uint32_t id = _intern_key(key.data(), key.length());
+    const uint32_t slot = find_slot(id);
+    if (slot == capacity)
+        return insert(id);
 
-    if (i == hash_map->end())
-    {
-        (*hash_map)[key]     = CrawlStoreValue();
-        CrawlStoreValue &val = (*hash_map)[key];
+    return slots()[slot].second;
+}
 
-        return val;
-    }
+CrawlStoreValue& CrawlHashTable::get_value(const char *key)
+{
+    ASSERT_VALIDITY();
+
+    ACCESS(key);
+    const uint32_t id = _intern_key(key, strlen(key));
+    const uint32_t slot = find_slot(id);
+    if (slot == capacity)
+        return insert(id);
 
-    return i->second;
+    return slots()[slot].second;
 }
 
-const CrawlStoreValue& CrawlHashTable::get_value(const string &key) const
+const CrawlStoreValue& CrawlHashTable::get_value(const char *key) const
 {
-#ifdef ASSERTS
-    if (!hash_map)
-        die("trying to read non-existent property \"%s\"", key.c_str());
-#endif
     ASSERT_VALIDITY();
 
     ACCESS(key);
-    hash_map_type::const_iterator i = hash_map->find(key);
+    const uint32_t slot = find_slot(_find_key(key, strlen(key)));
 
 #ifdef ASSERTS
-    if (i == hash_map->end())
-        die("trying to read non-existent property \"%s\"", key.c_str());
+    if (slot == capacity)
+        die("trying to read non-existent property \"%s\"", key);
 #endif
-    ASSERT(i->second.type != SV_NONE);
-    ASSERT(!(i->second.flags & SFLAG_UNSET));
+    const CrawlStoreValue &val = slots()[slot].second;
+    ASSERT(val.type != SV_NONE);
+    ASSERT(!(val.flags & SFLAG_UNSET));
+
+    return val;
+}
 
-    return i->second;
+const CrawlStoreValue& CrawlHashTable::get_value(const string &key) const
+{
+    return get_value(key.c_str());
 }
 
 ///////////////////////////
 // std::map style interface
 unsigned int CrawlHashTable::size() const
 {
-    if (hash_map == NULL)
-        return 0;
-
-    return hash_map->size();
+    return count;
 }
 
 bool CrawlHashTable::empty() const
 {
-    if (hash_map == NULL)
-        return true;
+    return !count;
+}
 
-    return hash_map->empty();
+void CrawlHashTable::erase(const string &key)
+{
+    erase(key.c_str());
 }
 
-void CrawlHashTable::erase(const string key)
+void CrawlHashTable::erase(const char *key)
 {
     ASSERT_VALIDITY();
-    init_hash_map();
 
     ACCESS(key);
-    iterator i = hash_map->find(key);
+    const uint32_t slot = find_slot(_find_key(key, strlen(key)));
 
-    if (i != hash_map->end())
+    if (slot != capacity)
     {
 #ifdef ASSERTS
-        CrawlStoreValue &val = i->second;
+        CrawlStoreValue &val = slots()[slot].second;
         ASSERT(!(val.flags & SFLAG_NO_ERASE));
 #endif
 
-        hash_map->erase(i);
+        erase_slot(slot);
     }
 }
 
 void CrawlHashTable::clear()
 {
     ASSERT_VALIDITY();
-    if (hash_map == NULL)
-        return;
 
-    delete hash_map;
-    hash_map = NULL;
+    entry *e = slots();
+    for (uint32_t i = 0; count && i < capacity; ++i)
+    {
+        if (e[i].first.id)
+        {
+            e[i].second.~CrawlStoreValue();
+            --count;
+        }
+    }
+
+    free(heap);
+    heap = NULL;
+    capacity = HASH_INLINE_SLOTS;
+    for (int i = 0; i < HASH_INLINE_SLOTS; ++i)
+        slots()[i].first.id = 0;
 }
 
 CrawlHashTable::iterator CrawlHashTable::begin()
 {
     ASSERT_VALIDITY();
-    init_hash_map();
 
-    return hash_map->begin();
+    return iterator(this, 0);
 }
 
 CrawlHashTable::iterator CrawlHashTable::end()
 {
     ASSERT_VALIDITY();
-    init_hash_map();
 
-    return hash_map->end();
+    return iterator(this, capacity);
 }
 
 CrawlHashTable::const_iterator CrawlHashTable::begin() const
 {
-    ASSERT(hash_map != NULL);
     ASSERT_VALIDITY();
 
-    return hash_map->begin();
+    return const_iterator(this, 0);
 }
 
 CrawlHashTable::const_iterator CrawlHashTable::end() const
 {
-    ASSERT(hash_map != NULL);
     ASSERT_VALIDITY();
 
-    return hash_map->end();
-}
-
-void CrawlHashTable::init_hash_map()
-{
-    if (hash_map != NULL)
-        return;
-
-    hash_map = new hash_map_type();
+    return const_iterator(this, capacity);
 }
 
 /////////////////////////////////////////////////////////////////////////////
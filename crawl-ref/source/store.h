@@ -258,16 +258,105 @@ public:
 
     ~CrawlHashTable();
 
-    typedef map<string, CrawlStoreValue>  hash_map_type;
-    typedef hash_map_type::iterator       iterator;
-    typedef hash_map_type::const_iterator const_iterator;
+    // Key names are interned, so that each distinct name is stored only
+    // once and tables compare keys as integers.
+    class key_type
+    {
+    public:
+        key_type() : id(0) { }
+        explicit key_type(uint32_t i) : id(i) { }
+
+        const string &name() const;
+        operator const string &() const { return name(); }
+        const char *c_str() const { return name().c_str(); }
+
+        uint32_t id;            // 0 for an empty slot
+    };
+
+    // Laid out like std::map's pairs, which tables used to be.
+    struct entry
+    {
+        key_type        first;
+        CrawlStoreValue second;
+    };
+
+    template <typename E, typename T>
+    class iterator_base
+    {
+    public:
+        iterator_base() : table(NULL), slot(0) { }
+        iterator_base(T *t, uint32_t s) : table(t), slot(s) { skip(); }
+        template <typename E2, typename T2>
+        iterator_base(const iterator_base<E2, T2> &o)
+            : table(o.table), slot(o.slot) { }
+
+        E &operator * () const { return table->slots()[slot]; }
+        E *operator -> () const { return &table->slots()[slot]; }
+
+        iterator_base &operator ++ () { ++slot; skip(); return *this; }
+        iterator_base operator ++ (int)
+        {
+            iterator_base old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator == (const iterator_base &o) const
+        {
+            return table == o.table && slot == o.slot;
+        }
+        bool operator != (const iterator_base &o) const
+        {
+            return !(*this == o);
+        }
+
+    private:
+        void skip()
+        {
+            while (slot < table->capacity && !table->slots()[slot].first.id)
+                ++slot;
+        }
+
+        T *table;
+        uint32_t slot;
+
+        template <typename E2, typename T2> friend class iterator_base;
+    };
+
+    typedef iterator_base<entry, CrawlHashTable>                   iterator;
+    typedef iterator_base<const entry, const CrawlHashTable> const_iterator;
 
 protected:
-    // NOTE: Not using auto_ptr because making hash_map an auto_ptr
-    // causes compile weirdness in externs.h
-    hash_map_type *hash_map;
-
-    void init_hash_map();
+    // Entries live in an open-addressed table with linear probing.  Tables
+    // of up to HASH_INLINE_SLOTS entries are kept inside the object itself,
+    // so most props never touch the heap.
+    enum { HASH_INLINE_SLOTS = 2 };
+
+    entry *heap;           // NULL while the entries are inline
+    uint32_t capacity;     // slots, a power of two
+    uint32_t count;
+    union
+    {
+        char bytes[HASH_INLINE_SLOTS * sizeof(entry)];
+        int64_t align_int;
+        void *align_ptr;
+    } inline_slots;
+
+    entry *slots()
+    {
+        return heap ? heap : reinterpret_cast<entry *>(inline_slots.bytes);
+    }
+    const entry *slots() const
+    {
+        return heap ? heap
+                    : reinterpret_cast<const entry *>(inline_slots.bytes);
+    }
+
+    uint32_t find_slot(uint32_t key) const;
+    CrawlStoreValue &insert(uint32_t key);
+    void grow();
+    void erase_slot(uint32_t slot);
+    void copy_from(const CrawlHashTable &other);
 
     friend class CrawlStoreValue;
 
@@ -278,17 +367,17 @@ public:
     void read(reader &);
 
     bool exists(const string &key) const;
+    bool exists(const char *key) const;
     void assert_validity() const;
 
     // NOTE: If the const versions of get_value() or [] are given a
     // key which doesn't exist, they will assert.
     const CrawlStoreValue& get_value(const string &key) const;
-    const CrawlStoreValue& get_value(const char *key) const
-    { return get_value(string(key)); }
+    const CrawlStoreValue& get_value(const char *key) const;
     const CrawlStoreValue& operator[] (const string &key) const
     { return get_value(key); }
     const CrawlStoreValue& operator[] (const char *key) const
-    { return get_value(string(key)); }
+    { return get_value(key); }
 
     // NOTE: If get_value() or [] is given a key which doesn't exist
     // in the table, an unset/empty CrawlStoreValue will be created
@@ -297,20 +386,22 @@ public:
     // hash table has a type (rather than being heterogeneous)
     // then trying to assign a different type to the CrawlStoreValue
     // will assert.
+    //
+    // Unlike with std::map, adding or erasing a key may move the other
+    // values, so don't hold on to references across that.
     CrawlStoreValue& get_value(const string &key);
-    CrawlStoreValue& get_value(const char *key)
-    { return get_value(string(key)); }
+    CrawlStoreValue& get_value(const char *key);
     CrawlStoreValue& operator[] (const string &key)
     { return get_value(key); }
     CrawlStoreValue& operator[] (const char *key)
-    { return get_value(string(key)); }
+    { return get_value(key); }
 
     // std::map style interface
     unsigned int size() const;
     bool      empty() const;
 
-    void      erase(const string key);
-    void      erase(const char *key) { erase(string(key)); }
+    void      erase(const string &key);
+    void      erase(const char *key);
     void      clear();
 
     const_iterator begin() const;
@@ -318,6 +409,9 @@ public:
 
     iterator  begin();
     iterator  end();
+
+    // How many distinct key names have been interned.
+    static unsigned int interned_keys();
 };
 
 // A CrawlVector is the vector version of CrawlHashTable, except that
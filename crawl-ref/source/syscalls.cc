@@ -19,6 +19,7 @@
 # include <fcntl.h>
 # include <sys/types.h>
 # include <sys/stat.h>
+# include <sys/time.h>
 #endif
 
 #include "files.h"
@@ -232,6 +233,24 @@ void usleep(unsigned long time)
 # endif
 #endif
 
+// Microseconds since the Unix epoch.
+uint64_t get_time_usec()
+{
+#ifdef TARGET_OS_WINDOWS
+    // MSVC has no gettimeofday().  FILETIME counts 100ns ticks from 1601.
+    FILETIME ft;
+    GetSystemTimeAsFileTime(&ft);
+    uint64_t tt = ft.dwHighDateTime;
+    tt <<= 32;
+    tt |= ft.dwLowDateTime;
+    return tt / 10 - 11644473600000000ULL;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000000ULL + tv.tv_usec;
+#endif
+}
+
 
 bool file_exists(const string &name)
 {
@@ -29,6 +29,8 @@ int fdatasync(int fd);
 void usleep(unsigned long time);
 #endif
 
+uint64_t get_time_usec();
+
 int rename_u(const char *oldpath, const char *newpath);
 int unlink_u(const char *pathname);
 FILE *fopen_u(const char *path, const char *mode);
@@ -72,6 +72,7 @@ enum tag_minor_version
     TAG_MINOR_16_BIT_TABLE,        // Increase the limit for CrawlVector/HashTable to 65535.
     TAG_MINOR_ABIL_1000,           // Start god ability enums at 1000.
     TAG_MINOR_CLASS_HP_0,          // Base class maxhp at 0.
+    TAG_MINOR_LEVEL_SUBCHUNKS,     // Level items/monsters/tiles in own chunks.
 #endif
     NUM_TAG_MINORS,
     TAG_MINOR_VERSION = NUM_TAG_MINORS - 1
@@ -32,6 +32,7 @@
 #include "art-enum.h"
 #include "artefact.h"
 #include "branch.h"
+#include "cloud.h"
 #include "coord.h"
 #include "coordit.h"
 #include "describe.h"
@@ -51,6 +52,7 @@
 #include "misc.h"
 #include "mislead.h"
 #include "mon-info.h"
+#include "mon-place.h"
 #if TAG_MAJOR_VERSION == 34
  #include "mon-chimera.h"
 #endif
@@ -218,7 +220,7 @@ void reader::fail_if_not_eof(const string &name)
     char dummy;
     if (_chunk ? _chunk->read(&dummy, 1) :
         _file ? (fgetc(_file) != EOF) :
-        _read_offset >= _pbuf->size())
+        _read_offset < _pbuf->size())
     {
         fail("Incomplete read of \"%s\" - aborting.", name.c_str());
     }
@@ -1009,11 +1011,14 @@ void tag_write(tag_type tagID, writer &outf)
         break;
     case TAG_LEVEL:
         tag_construct_level(th);
-        CANARY;
+        break;
+    case TAG_LEVEL_ITEMS:
         tag_construct_level_items(th);
-        CANARY;
+        break;
+    case TAG_LEVEL_MONSTERS:
         tag_construct_level_monsters(th);
-        CANARY;
+        break;
+    case TAG_LEVEL_TILES:
         tag_construct_level_tiles(th);
         break;
     case TAG_GHOST:
@@ -1077,11 +1082,26 @@ void tag_read(reader &inf, tag_type tag_id)
         break;
     case TAG_LEVEL:
         tag_read_level(th);
-        EAT_CANARY;
+#if TAG_MAJOR_VERSION == 34
+        // Older saves keep the whole level in a single chunk.
+        if (th.getMinorVersion() < TAG_MINOR_LEVEL_SUBCHUNKS)
+        {
+            EAT_CANARY;
+            tag_read_level_items(th);
+            EAT_CANARY;
+            tag_read_level_monsters(th);
+            EAT_CANARY;
+            tag_read_level_tiles(th);
+        }
+#endif
+        break;
+    case TAG_LEVEL_ITEMS:
         tag_read_level_items(th);
-        EAT_CANARY;
+        break;
+    case TAG_LEVEL_MONSTERS:
         tag_read_level_monsters(th);
-        EAT_CANARY;
+        break;
+    case TAG_LEVEL_TILES:
         tag_read_level_tiles(th);
         break;
     case TAG_GHOST:
@@ -2663,6 +2683,8 @@ static void tag_read_you(reader &th)
 
     you.props.clear();
     you.props.read(th);
+
+    you.invalidate_stat_cache();
 }
 
 static void tag_read_you_items(reader &th)
@@ -3915,8 +3937,6 @@ static void tag_read_level(reader &th)
 
     EAT_CANARY;
 
-    env.cloud_no = 0;
-
     // how many clouds?
     const int num_clouds = unmarshallShort(th);
     ASSERT_RANGE(num_clouds, 0, MAX_CLOUDS + 1);
@@ -3947,10 +3967,10 @@ static void tag_read_level(reader &th)
         ASSERT_IN_BOUNDS(env.cloud[i].pos);
 #endif
         env.cgrid(env.cloud[i].pos) = i;
-        env.cloud_no++;
     }
     for (int i = num_clouds; i < MAX_CLOUDS; i++)
         env.cloud[i].type = CLOUD_NONE;
+    rebuild_cloud_lists();
 
     EAT_CANARY;
 
@@ -4066,6 +4086,8 @@ static void tag_read_level_items(reader &th)
             item.clear();
     }
 #endif
+
+    rebuild_free_items();
 }
 
 void unmarshallMonster(reader &th, monster& m)
@@ -4395,6 +4417,8 @@ static void tag_read_level_monsters(reader &th)
         _fix_missing_constrictions();
     }
 #endif
+
+    rebuild_free_monsters();
 }
 
 static void _debug_count_tiles()
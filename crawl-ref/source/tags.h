@@ -21,6 +21,9 @@ enum tag_type   // used during save/load process to identify data blocks
     TAG_YOU,                            // the main part of the save
     TAG_LEVEL,                          // a single dungeon level
     TAG_GHOST,                          // ghost
+    TAG_LEVEL_ITEMS,                    // items on a dungeon level
+    TAG_LEVEL_MONSTERS,                 // monsters on a dungeon level
+    TAG_LEVEL_TILES,                    // tile flavour of a dungeon level
     NUM_TAGS,
 
     // Returned when a known tag was deliberately not read. This value is
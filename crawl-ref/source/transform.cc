@@ -1021,6 +1021,7 @@ bool transform(int pow, transformation_type which_trans, bool involuntary,
 
     // Update your status.
     you.form = which_trans;
+    you.invalidate_stat_cache();
     you.set_duration(DUR_TRANSFORMATION, _transform_duration(which_trans, pow));
     update_player_symbol();
 
@@ -1224,6 +1225,7 @@ void untransform(bool skip_wielding, bool skip_move)
     set<equipment_type> melded = _init_equipment_removal(old_form);
 
     you.form = TRAN_NONE;
+    you.invalidate_stat_cache();
     you.duration[DUR_TRANSFORMATION]   = 0;
     update_player_symbol();
 
@@ -1811,9 +1811,7 @@ void handle_items_on_shaft(const coord_def& pos, bool open_shaft)
             mitm[o].pos = INVALID_COORD;
             add_item_to_transit(dest, mitm[o]);
 
-            mitm[o].base_type = OBJ_UNASSIGNED;
-            mitm[o].quantity = 0;
-            mitm[o].props.clear();
+            mitm[o].clear();
         }
 
         o = next;
@@ -221,6 +221,7 @@ void wizard_change_species(void)
     calc_hp();
     calc_mp();
 
+    you.invalidate_stat_cache();
     burden_change();
     // The player symbol depends on species.
     update_player_symbol();